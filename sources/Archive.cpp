@@ -0,0 +1,593 @@
+#include "Archive.hpp"
+#include "Configuration.hpp"
+#include "FileSystem.hpp"
+#include "StringHelpers.hpp"
+
+#include <picosha2.h>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    static constexpr std::string_view const Magic = "RSCA";
+    static constexpr std::uint32_t const Version = 1u;
+    static constexpr std::size_t const HeaderSize = 64u;
+    static constexpr std::size_t const HeaderCount = 2u;
+    static constexpr std::size_t const HeaderChecksumOffset = HeaderSize - 4u;
+    static constexpr std::size_t const EntrySize = 64u;
+    static constexpr std::size_t const PayloadAlignment = 16u;
+    static constexpr std::size_t const CopyBufferSize = 1024u * 1024u;
+
+    struct ArchiveHeader
+    {
+        std::uint64_t indexOffset;
+        std::uint64_t indexSize;
+        std::uint64_t entryCount;
+        std::uint32_t indexChecksum;
+        std::uint64_t generation;
+        std::uint64_t garbageSize;
+    };
+
+    std::array<std::uint32_t, 256u> makeCrc32Table()
+    {
+        std::array<std::uint32_t, 256u> table{};
+
+        for (auto i = 0u; i < table.size(); ++i)
+        {
+            std::uint32_t value = i;
+
+            for (auto bit = 0u; bit < 8u; ++bit)
+                value = (value & 1u) != 0u ? 0xEDB88320u ^ (value >> 1u) : value >> 1u;
+
+            table[i] = value;
+        }
+
+        return table;
+    }
+
+    ArchiveEntry::Digest makeDigest(std::vector<char> const& content)
+    {
+        ArchiveEntry::Digest digest{};
+
+        picosha2::hash256(content.begin(), content.end(), digest.begin(), digest.end());
+
+        return digest;
+    }
+
+    void writeInteger(std::vector<char>& output, std::size_t position, std::uint64_t value, unsigned int size)
+    {
+        for (auto i = 0u; i < size; ++i)
+            output[position + i] = static_cast<char>(value >> (i * 8u));
+    }
+
+    void appendInteger(std::vector<char>& output, std::uint64_t value, unsigned int size)
+    {
+        output.resize(output.size() + size);
+        writeInteger(output, output.size() - size, value, size);
+    }
+
+    std::uint64_t readInteger(char const* bytes, unsigned int size)
+    {
+        std::uint64_t value = 0u;
+
+        for (auto i = 0u; i < size; ++i)
+            value |= static_cast<std::uint64_t>(static_cast<unsigned char>(bytes[i])) << (i * 8u);
+
+        return value;
+    }
+
+    std::uint64_t align(std::uint64_t position)
+    {
+        return (position + PayloadAlignment - 1u) / PayloadAlignment * PayloadAlignment;
+    }
+
+    std::vector<char> makeIndex(std::vector<ArchiveEntry> const& entries)
+    {
+        std::vector<char> index;
+        std::uint64_t keyOffset = 0u;
+
+        for (auto const& entry : entries)
+        {
+            appendInteger(index, entry.offset, 8u);
+            appendInteger(index, entry.size, 8u);
+            appendInteger(index, keyOffset, 4u);
+            appendInteger(index, entry.key.size(), 4u);
+            appendInteger(index, entry.checksum, 4u);
+            appendInteger(index, 0u, 4u);
+            index.insert(index.end(), entry.digest.begin(), entry.digest.end());
+            keyOffset += entry.key.size() + 1u;
+        }
+
+        for (auto const& entry : entries)
+            index.insert(index.end(), entry.key.c_str(), entry.key.c_str() + entry.key.size() + 1u);
+
+        return index;
+    }
+
+    std::vector<char> makeHeader(ArchiveHeader const& header)
+    {
+        std::vector<char> bytes(HeaderSize, '\0');
+
+        std::copy(Magic.begin(), Magic.end(), bytes.begin());
+        writeInteger(bytes, 4u, Version, 4u);
+        writeInteger(bytes, 8u, header.indexOffset, 8u);
+        writeInteger(bytes, 16u, header.indexSize, 8u);
+        writeInteger(bytes, 24u, header.entryCount, 4u);
+        writeInteger(bytes, 28u, header.indexChecksum, 4u);
+        writeInteger(bytes, 32u, header.generation, 8u);
+        writeInteger(bytes, 40u, header.garbageSize, 8u);
+        writeInteger(bytes, HeaderChecksumOffset, computeCrc32(bytes.data(), HeaderChecksumOffset), 4u);
+
+        return bytes;
+    }
+
+    std::optional<ArchiveHeader> parseHeader(char const* bytes)
+    {
+        if (std::string_view{bytes, Magic.size()} != Magic || readInteger(bytes + 4u, 4u) != Version
+            || readInteger(bytes + HeaderChecksumOffset, 4u) != computeCrc32(bytes, HeaderChecksumOffset))
+        {
+            return std::nullopt;
+        }
+
+        return ArchiveHeader{readInteger(bytes + 8u, 8u), readInteger(bytes + 16u, 8u), readInteger(bytes + 24u, 4u),
+                             static_cast<std::uint32_t>(readInteger(bytes + 28u, 4u)), readInteger(bytes + 32u, 8u),
+                             readInteger(bytes + 40u, 8u)};
+    }
+
+    /// Returns the slot of the header used and the header.
+    std::pair<std::size_t, ArchiveHeader> selectHeader(ArchiveReader const& read, std::uint64_t archiveSize)
+    {
+        std::vector<char> buffer;
+        std::optional<std::pair<std::size_t, ArchiveHeader>> selected;
+
+        if (archiveSize < HeaderSize * HeaderCount)
+            throw std::runtime_error("invalid archive: unknown format");
+
+        read(0u, HeaderSize * HeaderCount, buffer);
+
+        for (auto slot = 0u; slot < HeaderCount; ++slot)
+        {
+            auto const header = parseHeader(buffer.data() + slot * HeaderSize);
+
+            if (header.has_value() && (!selected.has_value() || header->generation > selected->second.generation))
+                selected = std::make_pair(slot, *header);
+        }
+
+        if (!selected.has_value())
+            throw std::runtime_error("invalid archive: unknown format or corrupted header");
+
+        return *selected;
+    }
+
+    /// Write the content of the file to the disk, std::fstream::flush() only hands it to the system.
+    /// The data written by any descriptor of the file are synchronized, the streams must be flushed before.
+    void syncFile(std::filesystem::path const& filePath)
+    {
+#if defined(_WIN32)
+        auto const descriptor = ::_wopen(filePath.c_str(), _O_RDWR | _O_BINARY);
+        auto const synced = descriptor >= 0 && ::_commit(descriptor) == 0;
+
+        if (descriptor >= 0)
+            ::_close(descriptor);
+#else
+        auto const descriptor = ::open(filePath.c_str(), O_RDWR);
+        auto const synced = descriptor >= 0 && ::fsync(descriptor) == 0;
+
+        if (descriptor >= 0)
+            ::close(descriptor);
+#endif
+
+        if (!synced)
+            throw std::runtime_error(format("unable to synchronize '{}'", filePath.generic_string()));
+    }
+
+    void writeAt(std::ostream& file, std::uint64_t position, char const* bytes, std::size_t size)
+    {
+        file.seekp(static_cast<std::streamoff>(position));
+        file.write(bytes, static_cast<std::streamsize>(size));
+    }
+
+    void writePadding(std::ostream& output, std::uint64_t& position)
+    {
+        auto const padding = align(position) - position;
+
+        output.write(std::string(padding, '\0').data(), static_cast<std::streamsize>(padding));
+        position += padding;
+    }
+
+    /// Write the index of 'entries' after the payloads ending at 'position', then the header in the first slot.
+    void writeIndex(std::ostream& output, std::uint64_t position, std::vector<ArchiveEntry> const& entries, std::uint64_t generation)
+    {
+        auto const index = makeIndex(entries);
+
+        writePadding(output, position);
+        output.write(index.data(), static_cast<std::streamsize>(index.size()));
+
+        auto const header = makeHeader(ArchiveHeader{position, index.size(), entries.size(), computeCrc32(index.data(), index.size()), generation, 0u});
+
+        writeAt(output, 0u, header.data(), header.size());
+    }
+
+    /// Write an archive containing 'resources'. The resources are loaded one at a time, and written as soon as loaded.
+    void writeResources(std::ostream& output, ResourceLoaders const& resources)
+    {
+        std::vector<char> content;
+        std::vector<ArchiveEntry> entries;
+        std::uint64_t position = HeaderSize * HeaderCount;
+
+        output.write(std::string(HeaderSize * HeaderCount, '\0').data(), static_cast<std::streamsize>(HeaderSize * HeaderCount));
+
+        for (auto const& [key, load] : resources)
+        {
+            load(content);
+            writePadding(output, position);
+            entries.push_back(ArchiveEntry{key, position, content.size(), computeCrc32(content.data(), content.size()), makeDigest(content)});
+            output.write(content.data(), static_cast<std::streamsize>(content.size()));
+            position += content.size();
+        }
+
+        writeIndex(output, position, entries, 1u);
+    }
+
+    /// Write an archive into a temporary file with 'write', then replace 'filePath'.
+    /// The processes having mapped the previous file keep their mapping.
+    void replaceFile(std::filesystem::path const& filePath, std::function<void(std::ostream&)> const& write)
+    {
+        auto const temporaryFilePath = makeTemporaryPath(filePath);
+
+        try
+        {
+            {
+                std::ofstream file{temporaryFilePath, std::ios::binary | std::ios::trunc};
+
+                if (!file.is_open())
+                    throw std::runtime_error(format("unable to open '{}' for writing", temporaryFilePath.generic_string()));
+
+                write(file);
+
+                if (!file.flush())
+                    throw std::runtime_error(format("unable to write '{}'", temporaryFilePath.generic_string()));
+            }
+
+            // The archive replaced must not be lost for a file whose content is not on the disk yet
+            syncFile(temporaryFilePath);
+        }
+        catch (...)
+        {
+            std::error_code error;
+
+            std::filesystem::remove(temporaryFilePath, error);
+            throw;
+        }
+
+        std::filesystem::rename(temporaryFilePath, filePath);
+    }
+
+    /// Rewrite the archive with only the payloads used by 'entries'.
+    /// The payloads are copied by chunks, the archive is never loaded entirely in memory.
+    void compactArchive(std::filesystem::path const& filePath, std::vector<ArchiveEntry> entries, std::uint64_t generation)
+    {
+        // The previous archive is closed before being replaced
+        replaceFile(filePath, [&](std::ostream& output)
+        {
+            std::ifstream input{filePath, std::ios::binary};
+            std::vector<char> buffer(CopyBufferSize);
+            std::map<std::uint64_t, std::uint64_t> newOffsets;
+            std::uint64_t position = HeaderSize * HeaderCount;
+
+            if (!input.is_open())
+                throw std::runtime_error(format("unable to compact '{}'", filePath.generic_string()));
+
+            output.write(std::string(HeaderSize * HeaderCount, '\0').data(), static_cast<std::streamsize>(HeaderSize * HeaderCount));
+
+            for (auto& entry : entries)
+            {
+                // A payload shared by several entries is copied once
+                if (auto const it = newOffsets.find(entry.offset); it != newOffsets.end())
+                {
+                    entry.offset = it->second;
+                    continue;
+                }
+
+                writePadding(output, position);
+                newOffsets.emplace(entry.offset, position);
+                input.seekg(static_cast<std::streamoff>(entry.offset));
+
+                for (std::uint64_t copied = 0u; copied < entry.size;)
+                {
+                    auto const count = static_cast<std::size_t>(std::min<std::uint64_t>(entry.size - copied, buffer.size()));
+
+                    if (!input.read(buffer.data(), static_cast<std::streamsize>(count)))
+                        throw std::runtime_error(format("unable to read '{}'", filePath.generic_string()));
+
+                    output.write(buffer.data(), static_cast<std::streamsize>(count));
+                    copied += count;
+                }
+
+                entry.offset = position;
+                position += entry.size;
+            }
+
+            writeIndex(output, position, entries, generation);
+        });
+    }
+
+    ArchiveIndex readIndex(ArchiveReader const& read, std::uint64_t archiveSize, ArchiveHeader const& header)
+    {
+        if (header.indexOffset > archiveSize || header.indexSize > archiveSize - header.indexOffset || header.entryCount * EntrySize > header.indexSize)
+            throw std::runtime_error("invalid archive: index out of the archive");
+
+        std::vector<char> index;
+
+        read(header.indexOffset, static_cast<std::size_t>(header.indexSize), index);
+
+        if (header.indexChecksum != computeCrc32(index.data(), index.size()))
+            throw std::runtime_error("invalid archive: corrupted index");
+
+        auto const* keys = index.data() + header.entryCount * EntrySize;
+        auto const keysSize = header.indexSize - header.entryCount * EntrySize;
+        ArchiveIndex result{header.generation, header.garbageSize, {}};
+
+        for (auto i = 0u; i < header.entryCount; ++i)
+        {
+            auto const* entry = index.data() + i * EntrySize;
+            auto const offset = readInteger(entry, 8u);
+            auto const size = readInteger(entry + 8u, 8u);
+            auto const keyOffset = readInteger(entry + 16u, 4u);
+            auto const keySize = readInteger(entry + 20u, 4u);
+            auto const checksum = static_cast<std::uint32_t>(readInteger(entry + 24u, 4u));
+            ArchiveEntry::Digest digest{};
+
+            if (keyOffset > keysSize || keySize >= keysSize - keyOffset || keys[keyOffset + keySize] != '\0')
+                throw std::runtime_error("invalid archive: key out of the index");
+
+            std::string key{keys + keyOffset, keySize};
+
+            if (!result.entries.empty() && result.entries.back().key >= key)
+                throw std::runtime_error("invalid archive: keys not ordered");
+
+            if (offset > archiveSize || size > archiveSize - offset)
+                throw std::runtime_error(format("invalid archive: resource '{}' out of the archive", key));
+
+            std::copy(entry + 32u, entry + 32u + digest.size(), digest.begin());
+            result.entries.push_back(ArchiveEntry{std::move(key), offset, size, checksum, digest});
+        }
+
+        return result;
+    }
+}
+
+std::uint32_t computeCrc32(char const* bytes, std::size_t size)
+{
+    static std::array<std::uint32_t, 256u> const table = makeCrc32Table();
+    std::uint32_t crc = ~0u;
+
+    for (std::size_t i = 0u; i < size; ++i)
+        crc = table[(crc ^ static_cast<unsigned char>(bytes[i])) & 0xFFu] ^ (crc >> 8u);
+
+    return ~crc;
+}
+
+std::vector<char> makeArchive(ResourceSet const& resources)
+{
+    std::ostringstream output{std::ios::binary};
+
+    writeResources(output, makeResourceLoaders(resources));
+
+    auto const archive = output.str();
+
+    return std::vector<char>(archive.begin(), archive.end());
+}
+
+void writeArchive(std::filesystem::path const& filePath, ResourceLoaders const& resources)
+{
+    replaceFile(filePath, [&resources](std::ostream& output){ writeResources(output, resources); });
+}
+
+ArchiveIndex readArchiveIndex(ArchiveReader const& read, std::uint64_t archiveSize)
+{
+    return readIndex(read, archiveSize, selectHeader(read, archiveSize).second);
+}
+
+std::vector<ArchiveEntry> readArchiveIndex(std::vector<char> const& archive)
+{
+    auto const read = [&archive](std::uint64_t offset, std::size_t size, std::vector<char>& buffer)
+    {
+        buffer.assign(archive.begin() + static_cast<std::ptrdiff_t>(offset), archive.begin() + static_cast<std::ptrdiff_t>(offset + size));
+    };
+    auto index = readArchiveIndex(read, archive.size());
+
+    for (auto const& entry : index.entries)
+    {
+        if (computeCrc32(archive.data() + entry.offset, entry.size) != entry.checksum)
+            throw std::runtime_error(format("invalid archive: resource '{}' corrupted", entry.key));
+    }
+
+    return std::move(index.entries);
+}
+
+ArchiveUpdate updateArchive(std::filesystem::path const& filePath, ResourceLoaders const& resources, unsigned int compactionThreshold)
+{
+    ArchiveUpdate update;
+    std::optional<ArchiveIndex> previous;
+    std::optional<std::pair<std::size_t, ArchiveHeader>> previousHeader;
+    std::error_code error;
+    auto const archiveSize = std::filesystem::file_size(filePath, error);
+    auto const read = [&filePath](std::uint64_t offset, std::size_t size, std::vector<char>& buffer)
+    {
+        LocalFileSystem{}.getContent(filePath, offset, size, buffer);
+    };
+
+    // An archive which does not exist or is invalid is written entirely
+    if (!error)
+    {
+        try
+        {
+            previousHeader = selectHeader(read, archiveSize);
+            previous = readIndex(read, archiveSize, previousHeader->second);
+        }
+        catch (std::runtime_error const&)
+        {
+            previous.reset();
+        }
+    }
+
+    if (!previous.has_value())
+    {
+        writeArchive(filePath, resources);
+        update.written = resources.size();
+        update.rewritten = true;
+        return update;
+    }
+
+    std::map<ArchiveEntry::Digest, ArchiveEntry const*> payloads;
+    std::vector<ArchiveEntry> entries;
+    std::set<std::uint64_t> usedOffsets;
+    std::vector<char> content;
+    auto position = archiveSize;
+    std::fstream file{filePath, std::ios::in | std::ios::out | std::ios::binary};
+
+    if (!file.is_open())
+        throw std::runtime_error(format("unable to open '{}' for writing", filePath.generic_string()));
+
+    for (auto const& entry : previous->entries)
+        payloads.emplace(entry.digest, &entry);
+
+    // The resources are loaded one at a time and their payloads are appended as soon as loaded. If one can't be
+    // loaded or written, what was appended is truncated: the current header does not refer to it.
+    auto const truncate = [&]()
+    {
+        file.close();
+        std::filesystem::resize_file(filePath, archiveSize, error);
+    };
+
+    file.seekp(static_cast<std::streamoff>(archiveSize));
+
+    try
+    {
+        for (auto const& [key, load] : resources)
+        {
+            load(content);
+
+            auto const digest = makeDigest(content);
+
+            // A payload having the same content is reused, even if it belongs to another key
+            if (auto const it = payloads.find(digest); it != payloads.end() && it->second->size == content.size())
+            {
+                entries.push_back(ArchiveEntry{key, it->second->offset, it->second->size, it->second->checksum, digest});
+                usedOffsets.insert(it->second->offset);
+                ++update.reused;
+                continue;
+            }
+
+            writePadding(file, position);
+            entries.push_back(ArchiveEntry{key, position, content.size(), computeCrc32(content.data(), content.size()), digest});
+            file.write(content.data(), static_cast<std::streamsize>(content.size()));
+            position += content.size();
+            ++update.written;
+        }
+    }
+    catch (...)
+    {
+        truncate();
+        throw;
+    }
+
+    auto const unchanged = entries.size() == previous->entries.size() && std::equal(entries.begin(), entries.end(), previous->entries.begin(),
+        [](ArchiveEntry const& left, ArchiveEntry const& right){ return left.key == right.key && left.offset == right.offset; });
+
+    for (auto const& entry : previous->entries)
+    {
+        if (resources.find(entry.key) == resources.end())
+            ++update.removed;
+    }
+
+    update.garbageSize = previous->garbageSize;
+    if (unchanged)
+        return update;
+
+    // The payloads not used anymore and the previous index become garbage
+    std::set<std::uint64_t> deadOffsets;
+
+    for (auto const& entry : previous->entries)
+    {
+        if (usedOffsets.find(entry.offset) == usedOffsets.end() && deadOffsets.insert(entry.offset).second)
+            update.garbageSize += entry.size;
+    }
+    update.garbageSize += previousHeader->second.indexSize;
+
+    auto const index = makeIndex(entries);
+    auto const generation = previous->generation + 1u;
+
+    writePadding(file, position);
+
+    auto const indexOffset = position;
+    auto const header = makeHeader(ArchiveHeader{indexOffset, index.size(), entries.size(), computeCrc32(index.data(), index.size()), generation, update.garbageSize});
+
+    // The header is written last, in the slot not used by the current header: if the update is interrupted
+    // before, the current header and everything it refers to are still valid. The payloads and the index are
+    // synchronized before, otherwise the disk could get the new header without them after a crash.
+    file.write(index.data(), static_cast<std::streamsize>(index.size()));
+
+    try
+    {
+        if (!file.flush())
+            throw std::runtime_error(format("unable to write '{}'", filePath.generic_string()));
+
+        syncFile(filePath);
+    }
+    catch (...)
+    {
+        truncate();
+        throw;
+    }
+
+    writeAt(file, (1u - previousHeader->first) * HeaderSize, header.data(), header.size());
+
+    if (!file.flush())
+        throw std::runtime_error(format("unable to write '{}'", filePath.generic_string()));
+
+    syncFile(filePath);
+    file.close();
+
+    auto const newSize = indexOffset + index.size();
+
+    if (update.garbageSize * 100u > newSize * compactionThreshold)
+    {
+        compactArchive(filePath, std::move(entries), generation + 1u);
+        update.garbageSize = 0u;
+        update.compacted = true;
+    }
+
+    return update;
+}
+
+void checkOverlay(Configuration const& overlay, Configuration const& embedded)
+{
+    for (auto const& input : overlay.inputs)
+    {
+        auto const it = std::find_if(embedded.inputs.begin(), embedded.inputs.end(), [&input](Input const& embeddedInput){ return embeddedInput.key == input.key; });
+
+        if (it == embedded.inputs.end())
+            throw std::runtime_error(format("{}:{}: '{}' is not a resource of '{}'", overlay.configurationFilePath.generic_string(), input.line, input.key, embedded.configurationFilePath.generic_string()));
+
+        if (it->lineIndex || !it->columnTypes.empty() || it->json || it->dictionaryType != DictionaryType::None || it->frameSize > 0u)
+            throw std::runtime_error(format("{}:{}: '{}' can't be replaced, it's not embedded as is", overlay.configurationFilePath.generic_string(), input.line, input.key));
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef RESCOM_ARCHIVE_HPP
+#define RESCOM_ARCHIVE_HPP
+#include "ResourceSet.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+/// \brief External archive of resources, loaded at runtime by the generated function rescom::reload()
+/// The layout is designed to be mapped in memory and used without being decoded (integers are little endian):
+/// - two slots of 64 bytes for the header: magic "RSCA", version, offset and size of the index, count of entries,
+///   checksum of the index, generation, count of bytes not used anymore and checksum of the header,
+/// - the payloads, each aligned to 16 bytes,
+/// - the index: one entry of 64 bytes per resource, ordered by key (offset and size of the payload, offset and size
+///   of the key, checksum and SHA-256 of the payload), followed by the keys, each terminated by a null character.
+/// The valid header having the highest generation is used. An update appends the new payloads and a new index, then
+/// writes the header in the other slot: until then the previous header stays valid.
+/// Checksums are CRC-32. The generated code computes them the same way to validate an archive before using it.
+struct ArchiveEntry
+{
+    using Digest = std::array<unsigned char, 32u>;
+
+    std::string key;
+    std::uint64_t offset;
+    std::uint64_t size;
+    std::uint32_t checksum;
+    Digest digest;
+};
+
+struct ArchiveIndex
+{
+    std::uint64_t generation = 0u;
+    /// Count of bytes used by the payloads and the indexes replaced by updates
+    std::uint64_t garbageSize = 0u;
+    /// Entries ordered by key
+    std::vector<ArchiveEntry> entries;
+};
+
+/// Result of updateArchive()
+struct ArchiveUpdate
+{
+    /// Count of resources written in the archive
+    std::size_t written = 0u;
+    /// Count of resources whose content was already in the archive
+    std::size_t reused = 0u;
+    /// Count of resources removed from the archive
+    std::size_t removed = 0u;
+    /// Count of bytes not used anymore once updated
+    std::uint64_t garbageSize = 0u;
+    /// True if the archive was written entirely
+    bool rewritten = false;
+    /// True if the archive was compacted after the update
+    bool compacted = false;
+};
+
+/// Function reading 'size' bytes at 'offset' of the archive into 'buffer'.
+using ArchiveReader = std::function<void(std::uint64_t offset, std::size_t size, std::vector<char>& buffer)>;
+
+/// An archive is compacted when more than this percentage of its bytes are garbage.
+static constexpr unsigned int const DefaultCompactionThreshold = 50u;
+
+std::uint32_t computeCrc32(char const* bytes, std::size_t size);
+
+/// Make an archive containing 'resources'.
+std::vector<char> makeArchive(ResourceSet const& resources);
+
+/// Write an archive containing 'resources' into a temporary file, then replace 'filePath'.
+/// The resources are loaded one at a time and written as soon as loaded, the archive is never entirely in memory.
+/// The processes having mapped the previous file keep their mapping.
+void writeArchive(std::filesystem::path const& filePath, ResourceLoaders const& resources);
+
+/// Read the header and the index of an archive of 'archiveSize' bytes. The payloads are not read.
+/// Throws std::runtime_error if the header or the index is invalid.
+ArchiveIndex readArchiveIndex(ArchiveReader const& read, std::uint64_t archiveSize);
+
+/// Returns the entries of an archive, ordered by key.
+/// Throws std::runtime_error if the archive or one of its payloads is invalid.
+std::vector<ArchiveEntry> readArchiveIndex(std::vector<char> const& archive);
+
+/// Update the archive 'filePath' in place to contain 'resources'.
+/// Only the new and the changed resources are written, their previous payloads become garbage. The resources are
+/// compared using their SHA-256. The archive is compacted when its garbage exceeds 'compactionThreshold' percent of its
+/// size, and rewritten if it does not exist or is invalid. A compacted or rewritten archive replaces the previous file,
+/// so the processes having mapped it keep their mapping. The resources are loaded one at a time, like writeArchive().
+ArchiveUpdate updateArchive(std::filesystem::path const& filePath, ResourceLoaders const& resources,
+                            unsigned int compactionThreshold = DefaultCompactionThreshold);
+
+/// Check that each resource of 'overlay' replaces a resource of 'embedded' stored as is, without the options
+/// 'lines', 'csv', 'json', 'map', 'set' and 'compress': an overlay archive only replaces the content of a resource.
+/// Throws std::runtime_error otherwise.
+void checkOverlay(Configuration const& overlay, Configuration const& embedded);
+
+#endif //RESCOM_ARCHIVE_HPP
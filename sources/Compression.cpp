@@ -0,0 +1,200 @@
+#include "Compression.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    static constexpr std::size_t const MinMatch = 4u;
+    static constexpr std::size_t const MaxOffset = 65535u;
+    static constexpr unsigned int const HashBits = 16u;
+    static constexpr unsigned int const MinHashBits = 8u;
+    static constexpr std::size_t const LengthMask = 15u;
+
+    std::uint32_t read32(char const* bytes)
+    {
+        std::uint32_t value;
+
+        std::memcpy(&value, bytes, sizeof(value));
+
+        return value;
+    }
+
+    std::uint32_t hash(std::uint32_t value, unsigned int hashBits)
+    {
+        return (value * 2654435761u) >> (32u - hashBits);
+    }
+
+    /// Lengths greater than 15 are written as a sequence of bytes added to 15, terminated by a byte lesser than 255.
+    void writeExtendedLength(std::vector<char>& output, std::size_t length)
+    {
+        for (; length >= 255u; length -= 255u)
+            output.push_back(static_cast<char>(255u));
+
+        output.push_back(static_cast<char>(length));
+    }
+
+    /// Write a sequence, the last sequence of a frame has a match length of 0.
+    void writeSequence(std::vector<char>& output, char const* literals, std::size_t literalCount, std::size_t offset, std::size_t matchLength)
+    {
+        auto const matchCode = matchLength > 0u ? matchLength - MinMatch : 0u;
+        auto const literalNibble = literalCount < LengthMask ? literalCount : LengthMask;
+        auto const matchNibble = matchCode < LengthMask ? matchCode : LengthMask;
+
+        output.push_back(static_cast<char>((literalNibble << 4u) | matchNibble));
+        if (literalNibble == LengthMask)
+            writeExtendedLength(output, literalCount - LengthMask);
+
+        output.insert(output.end(), literals, literals + literalCount);
+
+        if (matchLength == 0u)
+            return;
+
+        output.push_back(static_cast<char>(offset & 0xFFu));
+        output.push_back(static_cast<char>(offset >> 8u));
+        if (matchNibble == LengthMask)
+            writeExtendedLength(output, matchCode - LengthMask);
+    }
+
+    std::size_t readExtendedLength(std::vector<char> const& frame, std::size_t& position)
+    {
+        std::size_t length = 0u;
+        unsigned char byte = 255u;
+
+        while (byte == 255u)
+        {
+            if (position == frame.size())
+                throw std::runtime_error("truncated frame");
+
+            byte = static_cast<unsigned char>(frame[position++]);
+            length += byte;
+        }
+
+        return length;
+    }
+
+    /// The table of the positions of the hashes is reused between the frames, and sized to the frame: a table larger
+    /// than the frame has no more candidates but costs its reset.
+    std::vector<char> compressFrame(char const* bytes, std::size_t size, std::vector<std::int64_t>& table)
+    {
+        auto hashBits = MinHashBits;
+
+        while (hashBits < HashBits && (std::size_t{1u} << hashBits) < size)
+            ++hashBits;
+
+        table.assign(std::size_t{1u} << hashBits, -1);
+
+        std::vector<char> output;
+        std::size_t anchor = 0u;
+        std::size_t i = 0u;
+
+        output.reserve(size / 2u + 16u);
+
+        // Greedy parsing: the first match found using the hash of the next 4 bytes is used.
+        while (i + MinMatch <= size)
+        {
+            auto const value = read32(bytes + i);
+            auto const h = hash(value, hashBits);
+            auto const candidate = table[h];
+
+            table[h] = static_cast<std::int64_t>(i);
+
+            if (candidate >= 0 && i - static_cast<std::size_t>(candidate) <= MaxOffset && read32(bytes + candidate) == value)
+            {
+                auto const match = static_cast<std::size_t>(candidate);
+                auto length = MinMatch;
+
+                while (i + length < size && bytes[match + length] == bytes[i + length])
+                    ++length;
+
+                writeSequence(output, bytes + anchor, i - anchor, i - match, length);
+                i += length;
+                anchor = i;
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        writeSequence(output, bytes + anchor, size - anchor, 0u, 0u);
+
+        return output;
+    }
+}
+
+std::vector<char> compressFrame(char const* bytes, std::size_t size)
+{
+    std::vector<std::int64_t> table;
+
+    return compressFrame(bytes, size, table);
+}
+
+std::vector<char> decompressFrame(std::vector<char> const& frame, std::size_t size)
+{
+    std::vector<char> output;
+    std::size_t position = 0u;
+
+    output.reserve(size);
+
+    while (position < frame.size())
+    {
+        auto const token = static_cast<unsigned char>(frame[position++]);
+        std::size_t literalCount = token >> 4u;
+
+        if (literalCount == LengthMask)
+            literalCount += readExtendedLength(frame, position);
+
+        if (literalCount > frame.size() - position)
+            throw std::runtime_error("truncated frame");
+
+        output.insert(output.end(), frame.begin() + static_cast<std::ptrdiff_t>(position), frame.begin() + static_cast<std::ptrdiff_t>(position + literalCount));
+        position += literalCount;
+
+        if (position == frame.size())
+            break;
+
+        if (position + 2u > frame.size())
+            throw std::runtime_error("truncated frame");
+
+        auto const offset = static_cast<std::size_t>(static_cast<unsigned char>(frame[position])) | (static_cast<std::size_t>(static_cast<unsigned char>(frame[position + 1u])) << 8u);
+        std::size_t length = (token & LengthMask) + MinMatch;
+
+        position += 2u;
+        if ((token & LengthMask) == LengthMask)
+            length += readExtendedLength(frame, position);
+
+        if (offset == 0u || offset > output.size())
+            throw std::runtime_error("invalid match offset");
+
+        // The match can overlap the bytes it produces, so it's copied byte by byte.
+        for (auto match = output.size() - offset; length > 0u; --length)
+            output.push_back(output[match++]);
+    }
+
+    if (output.size() != size)
+        throw std::runtime_error("invalid frame size");
+
+    return output;
+}
+
+CompressedFrames compressFrames(std::vector<char> const& buffer, std::size_t frameSize)
+{
+    CompressedFrames result;
+
+    result.frameSize = frameSize;
+    result.offsets.push_back(0u);
+
+    std::vector<std::int64_t> table;
+
+    for (std::size_t begin = 0u; begin < buffer.size(); begin += frameSize)
+    {
+        auto const size = buffer.size() - begin < frameSize ? buffer.size() - begin : frameSize;
+        auto const frame = compressFrame(buffer.data() + begin, size, table);
+
+        result.data.insert(result.data.end(), frame.begin(), frame.end());
+        result.offsets.push_back(static_cast<std::uint32_t>(result.data.size()));
+    }
+
+    return result;
+}
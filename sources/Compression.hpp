@@ -0,0 +1,28 @@
+#ifndef RESCOM_COMPRESSION_HPP
+#define RESCOM_COMPRESSION_HPP
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// \brief Resource compressed in frames decodable independently
+/// Each frame is a LZ77 block using the sequence format of LZ4: a token (literal length, match length),
+/// the literals, then a 16 bits little endian offset and the extended match length.
+/// The last sequence of a frame has only literals.
+struct CompressedFrames
+{
+    static constexpr std::size_t const DefaultFrameSize = 64u * 1024u;
+
+    /// Size of the uncompressed frames, except the last one which can be smaller
+    std::size_t frameSize = DefaultFrameSize;
+    /// Concatenation of the compressed frames
+    std::vector<char> data;
+    /// Offset of each frame in data, plus the end sentinel (seek table)
+    std::vector<std::uint32_t> offsets;
+};
+
+std::vector<char> compressFrame(char const* bytes, std::size_t size);
+/// Throws std::runtime_error if 'frame' is not a valid frame of 'size' bytes.
+std::vector<char> decompressFrame(std::vector<char> const& frame, std::size_t size);
+CompressedFrames compressFrames(std::vector<char> const& buffer, std::size_t frameSize);
+
+#endif //RESCOM_COMPRESSION_HPP
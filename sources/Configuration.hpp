@@ -1,10 +1,16 @@
 #ifndef RESCOM_CONFIGURATION_HPP
 #define RESCOM_CONFIGURATION_HPP
 #include <filesystem>
+#include <optional>
 #include <string>
 #include <cstdint>
 #include <vector>
 #include "LegacyCppCodeGenerator.hpp"
+#include "CsvTable.hpp"
+#include "Dictionary.hpp"
+#include "Transform.hpp"
+#include "Variants.hpp"
+#include "Compression.hpp"
 
 struct Input
 {
@@ -16,6 +22,24 @@ struct Input
     std::uint64_t size;
     /// The line where this input has been parsed
     std::size_t line;
+    /// If true a line index is generated, allowing random access to the lines of the resource (option 'lines')
+    bool lineIndex = false;
+    /// If not empty the resource is a CSV table converted into typed arrays, one type per column (option 'csv')
+    std::vector<ColumnType> columnTypes{};
+    /// If true the first line of the CSV table is its header, naming the columns (option 'csv=header,...')
+    bool tableHeader = false;
+    /// If true the resource is a JSON document validated and converted into a binary representation (option 'json')
+    bool json = false;
+    /// If not None the resource is a dictionary converted into a perfect hash table (options 'map' and 'set')
+    DictionaryType dictionaryType = DictionaryType::None;
+    /// If not zero the resource is compressed in frames of this size, decodable independently (option 'compress')
+    std::size_t frameSize = 0u;
+    /// If set the entry is a tar archive replaced by its members matching this glob (option 'tar')
+    std::optional<std::string> archiveGlob{};
+    /// If set the resource is a member of the tar archive 'filePath' and its content starts at this offset
+    std::optional<std::uint64_t> archiveOffset{};
+    /// Transforms applied to the content of the file before it's embedded, in order
+    std::vector<TransformPointer> transforms{};
 };
 
 /// Defines files to embed as resources.
@@ -31,6 +55,28 @@ struct Configuration
 
     /// Tabulation size of the generated code.
     unsigned int tabulationSize = 4u;
+
+    /// Directory where the results of the transforms are cached, if any.
+    std::optional<std::filesystem::path> cacheDirectory{};
+
+    /// Dimensions of variation declared with the directive @dimension.
+    std::vector<VariantDimension> dimensions{};
+
+    /// Groups of resources declared with the directive @variants.
+    /// Those groups are ordered by key.
+    std::vector<VariantGroup> variantGroups{};
+
+    /// Resources of at most this size are stored in their slot of the index, if enabled with the directive @inline.
+    std::size_t inlineThreshold = 0u;
+
+    /// Budget in bytes of the cache of decoded resources, if enabled with the directive @cached.
+    std::optional<std::size_t> runtimeCacheBudget{};
+
+    /// If true the code loading external archives of resources is generated, enabled with the directive @archive.
+    bool externalArchive = false;
+
+    /// Path of the archive whose resources replace the embedded ones, mapped at startup (directive @overlay).
+    std::optional<std::string> overlayPath{};
 };
 
 #endif //RESCOM_CONFIGURATION_HPP
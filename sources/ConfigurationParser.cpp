@@ -1,16 +1,39 @@
 #include "ConfigurationParser.hpp"
 #include "FileSystem.hpp"
 #include "StringHelpers.hpp"
+#include "Tar.hpp"
 
 #include <string_view>
 #include <fstream>
 #include <filesystem>
 #include <algorithm>
 #include <sstream>
+#include <charconv>
+#include <limits>
+#include <optional>
+#include <map>
 
 namespace
 {
     static constexpr char const* const OneLineCommentStart = "#";
+    static constexpr char const OptionsSeparator = '|';
+    static constexpr std::string_view const OptionsDirective = "@options";
+    static constexpr std::size_t const MaxFrameSize = 16u * 1024u * 1024u;
+    static constexpr std::string_view const DimensionDirective = "@dimension";
+    static constexpr std::string_view const VariantsDirective = "@variants";
+    static constexpr std::string_view const CachedDirective = "@cached";
+    static constexpr std::size_t const DefaultCacheBudget = 64u * 1024u * 1024u;
+    static constexpr std::string_view const InlineDirective = "@inline";
+    static constexpr std::size_t const DefaultInlineThreshold = 16u;
+    static constexpr std::size_t const MaxInlineThreshold = 64u;
+    static constexpr std::string_view const ArchiveDirective = "@archive";
+    static constexpr std::string_view const OverlayDirective = "@overlay";
+    static constexpr std::string_view const FallbackSeparator = ">";
+
+    inline bool startsWith(std::string_view view, std::string_view prefix)
+    {
+        return view.substr(0u, prefix.size()) == prefix;
+    }
 
     inline std::string_view cleanLine(std::string_view view, char const* oneLineCommentStart)
     {
@@ -32,18 +55,422 @@ namespace
         }
     }
 
+    /// Parse a size in bytes, the suffixes k and M are allowed.
+    /// Returns nothing if the size is invalid or too large.
+    std::optional<std::size_t> parseByteSize(std::string_view text)
+    {
+        std::size_t multiplier = 1u;
+        std::size_t size = 0u;
+
+        if (!text.empty() && (text.back() == 'k' || text.back() == 'M'))
+        {
+            multiplier = text.back() == 'k' ? 1024u : 1024u * 1024u;
+            text.remove_suffix(1u);
+        }
+
+        auto const [end, error] = std::from_chars(text.data(), text.data() + text.size(), size);
+
+        if (text.empty() || error != std::errc{} || end != text.data() + text.size() || size > std::numeric_limits<std::size_t>::max() / multiplier)
+            return std::nullopt;
+
+        return size * multiplier;
+    }
+
+    /// Apply the option 'name' (with an optional value) to 'input'.
+    /// 'line' is the line where the option is declared.
+    /// Throws std::runtime_error if the option is unknown or if the value is invalid.
+    void applyOption(Input& input, std::string_view name, std::string_view value, std::size_t line,
+                     std::filesystem::path const& configurationFilePath)
+    {
+        if ((name == "lines" || name == "json" || name == "map" || name == "set") && !value.empty())
+        {
+            throw std::runtime_error(format("{}:{}: option '{}' does not take a value", configurationFilePath.generic_string(), line, name));
+        }
+        else if (name == "lines")
+        {
+            input.lineIndex = true;
+        }
+        else if (name == "json")
+        {
+            input.json = true;
+        }
+        else if (name == "map")
+        {
+            input.dictionaryType = DictionaryType::Map;
+        }
+        else if (name == "set")
+        {
+            input.dictionaryType = DictionaryType::Set;
+        }
+        else if (name == "compress")
+        {
+            auto const frameSize = value.empty() ? std::optional<std::size_t>{CompressedFrames::DefaultFrameSize} : parseByteSize(value);
+
+            if (!frameSize.has_value() || *frameSize == 0u || *frameSize > MaxFrameSize)
+                throw std::runtime_error(format("{}:{}: invalid frame size '{}'", configurationFilePath.generic_string(), line, value));
+
+            input.frameSize = *frameSize;
+        }
+        else if (name == "tar")
+        {
+            input.archiveGlob = value.empty() ? std::string{"**"} : std::string{value};
+        }
+        else if (name == "csv")
+        {
+            auto typeNames = split(value, ',');
+
+            input.columnTypes.clear();
+            input.tableHeader = typeNames.front() == "header";
+            if (input.tableHeader)
+                typeNames.erase(typeNames.begin());
+
+            if (typeNames.empty())
+                throw std::runtime_error(format("{}:{}: column types expected after 'header'", configurationFilePath.generic_string(), line));
+
+            for (auto const& typeName : typeNames)
+            {
+                auto const type = toColumnType(typeName);
+
+                if (!type.has_value())
+                    throw std::runtime_error(format("{}:{}: invalid column type '{}'", configurationFilePath.generic_string(), line, typeName));
+
+                input.columnTypes.push_back(*type);
+            }
+        }
+        else if (isTransformRegistered(std::string{name}))
+        {
+            try
+            {
+                input.transforms.push_back(instanciateTransform(std::string{name}, value));
+            }
+            catch (std::runtime_error const& error)
+            {
+                throw std::runtime_error(format("{}:{}: {}", configurationFilePath.generic_string(), line, error.what()));
+            }
+        }
+        else
+        {
+            throw std::runtime_error(format("{}:{}: unknown option '{}'", configurationFilePath.generic_string(), line, name));
+        }
+    }
+
+    /// Parse the options following the separator '|'.
+    /// Options are separated by spaces, each option is either a name or a pair name=value.
+    /// A value containing spaces can be written between double quotes, \" and \\ are the escape sequences
+    /// allowed in such value.
+    void parseOptions(Input& input, std::string_view options, std::size_t line, std::filesystem::path const& configurationFilePath)
+    {
+        static constexpr char const* const Spaces = " \t";
+
+        while (!(options = trim(options)).empty())
+        {
+            auto const nameEnd = std::min(options.find_first_of("= \t"), options.size());
+            auto const name = options.substr(0u, nameEnd);
+            std::string value;
+
+            options.remove_prefix(nameEnd);
+
+            if (!options.empty() && options.front() == '=')
+            {
+                options.remove_prefix(1u);
+
+                if (!options.empty() && options.front() == '"')
+                {
+                    auto i = 1u;
+
+                    for (; i < options.size() && options[i] != '"'; ++i)
+                    {
+                        if (options[i] == '\\' && i + 1u < options.size())
+                            ++i;
+
+                        value.push_back(options[i]);
+                    }
+
+                    if (i == options.size())
+                        throw std::runtime_error(format("{}:{}: unterminated value of option '{}'", configurationFilePath.generic_string(), line, name));
+
+                    options.remove_prefix(i + 1u);
+                }
+                else
+                {
+                    auto const valueEnd = std::min(options.find_first_of(Spaces), options.size());
+
+                    value = options.substr(0u, valueEnd);
+                    options.remove_prefix(valueEnd);
+                }
+            }
+
+            applyOption(input, name, value, line, configurationFilePath);
+        }
+    }
+
+    /// Options applied to each input matching a glob pattern, declared with:
+    /// @options <pattern> | <options>
+    struct OptionsRule
+    {
+        std::string pattern;
+        std::string options;
+        std::size_t line;
+    };
+
+    /// Parse a dimension declared with:
+    /// @dimension <name> | <value>[><fallback>] ...
+    VariantDimension parseDimension(std::string_view name, std::string_view values, std::size_t line,
+                                    std::filesystem::path const& configurationFilePath)
+    {
+        VariantDimension dimension{std::string{name}, {}, {}, line};
+        std::vector<std::string> fallbackNames;
+
+        if (name.empty() || name.find_first_of(" \t{}") != std::string_view::npos)
+            throw std::runtime_error(format("{}:{}: invalid dimension name '{}'", configurationFilePath.generic_string(), line, name));
+
+        for (auto const& item : split(values, ' '))
+        {
+            auto const separatorPosition = item.find(FallbackSeparator);
+            auto const value = trim(item.substr(0u, separatorPosition));
+
+            if (item.empty())
+                continue;
+
+            if (value.empty())
+                throw std::runtime_error(format("{}:{}: value expected before '{}'", configurationFilePath.generic_string(), line, FallbackSeparator));
+
+            if (std::find(dimension.values.begin(), dimension.values.end(), value) != dimension.values.end())
+                throw std::runtime_error(format("{}:{}: value '{}' declared twice", configurationFilePath.generic_string(), line, value));
+
+            dimension.values.emplace_back(value);
+            fallbackNames.emplace_back(separatorPosition != std::string_view::npos ? item.substr(separatorPosition + 1u) : std::string_view{});
+        }
+
+        if (dimension.values.empty())
+            throw std::runtime_error(format("{}:{}: dimension '{}' has no value", configurationFilePath.generic_string(), line, name));
+
+        for (auto const& fallbackName : fallbackNames)
+        {
+            if (fallbackName.empty())
+            {
+                dimension.fallbacks.emplace_back();
+                continue;
+            }
+
+            auto const it = std::find(dimension.values.begin(), dimension.values.end(), fallbackName);
+
+            if (it == dimension.values.end())
+                throw std::runtime_error(format("{}:{}: unknown fallback '{}'", configurationFilePath.generic_string(), line, fallbackName));
+
+            dimension.fallbacks.emplace_back(static_cast<std::size_t>(it - dimension.values.begin()));
+        }
+
+        // A chain of fallbacks can not be longer than the count of values, otherwise there is a cycle.
+        for (auto value = 0u; value < dimension.values.size(); ++value)
+        {
+            auto current = dimension.fallbacks[value];
+
+            for (auto step = 0u; current.has_value(); ++step, current = dimension.fallbacks[*current])
+            {
+                if (step == dimension.values.size())
+                    throw std::runtime_error(format("{}:{}: cycle in the fallbacks of '{}'", configurationFilePath.generic_string(), line, dimension.values[value]));
+            }
+        }
+
+        return dimension;
+    }
+
+    /// Parse a group of resources declared with:
+    /// @variants <key> = <pattern>
+    VariantGroup parseVariantGroup(std::string_view declaration, std::vector<VariantDimension> const& dimensions, std::size_t line,
+                                   std::filesystem::path const& configurationFilePath)
+    {
+        auto const separatorPosition = declaration.find('=');
+
+        if (separatorPosition == std::string_view::npos)
+            throw std::runtime_error(format("{}:{}: expected {} <key> = <pattern>", configurationFilePath.generic_string(), line, VariantsDirective));
+
+        auto const key = trim(declaration.substr(0u, separatorPosition));
+        auto const pattern = trim(declaration.substr(separatorPosition + 1u));
+        auto const placeholderBegin = pattern.find('{');
+        auto const placeholderEnd = pattern.find('}', placeholderBegin);
+
+        if (key.empty() || pattern.empty())
+            throw std::runtime_error(format("{}:{}: expected {} <key> = <pattern>", configurationFilePath.generic_string(), line, VariantsDirective));
+
+        if (placeholderBegin == std::string_view::npos || placeholderEnd == std::string_view::npos)
+            throw std::runtime_error(format("{}:{}: pattern '{}' has no placeholder {<dimension>}", configurationFilePath.generic_string(), line, pattern));
+
+        auto const dimensionName = pattern.substr(placeholderBegin + 1u, placeholderEnd - placeholderBegin - 1u);
+        auto const it = std::find_if(dimensions.begin(), dimensions.end(), [dimensionName](VariantDimension const& dimension)
+        {
+            return dimension.name == dimensionName;
+        });
+
+        if (it == dimensions.end())
+            throw std::runtime_error(format("{}:{}: unknown dimension '{}'", configurationFilePath.generic_string(), line, dimensionName));
+
+        return VariantGroup{std::string{key}, std::string{pattern}, static_cast<std::size_t>(it - dimensions.begin()), line};
+    }
+
+    void applyRules(Input& input, std::vector<OptionsRule> const& rules, std::filesystem::path const& configurationFilePath)
+    {
+        for (auto const& rule : rules)
+        {
+            if (matchGlob(rule.pattern, input.key))
+                parseOptions(input, rule.options, rule.line, configurationFilePath);
+        }
+    }
+
+    /// Replace each tar archive by its members matching the glob of the option 'tar'.
+    /// A member gets the options of the archive, then the options of the rules matching its own key.
+    /// A path stored several times in an archive is extracted as its last member, like tar does.
+    std::vector<Input> expandArchives(std::unique_ptr<FileSystem> const& fileSystem, std::vector<Input>&& inputs,
+                                      std::vector<OptionsRule> const& rules, std::filesystem::path const& configurationFilePath)
+    {
+        std::vector<Input> result;
+
+        for (auto& input : inputs)
+        {
+            if (!input.archiveGlob.has_value())
+            {
+                result.emplace_back(std::move(input));
+                continue;
+            }
+
+            std::vector<TarMember> members;
+
+            try
+            {
+                members = listTarMembers([&fileSystem, &input](std::uint64_t offset, std::size_t size, std::vector<char>& buffer)
+                {
+                    fileSystem->getContent(input.filePath, offset, size, buffer);
+                }, input.size);
+            }
+            catch (std::exception const& error)
+            {
+                throw std::runtime_error(format("{}:{}: invalid tar archive '{}': {}", configurationFilePath.generic_string(), input.line, input.key, error.what()));
+            }
+
+            // Position in 'result' of the member having each path
+            std::map<std::string, std::size_t> positions;
+
+            for (auto& member : members)
+            {
+                if (!matchGlob(*input.archiveGlob, member.path))
+                    continue;
+
+                Input memberInput = input;
+
+                memberInput.key = std::move(member.path);
+                memberInput.size = member.size;
+                memberInput.archiveOffset = member.offset;
+                applyRules(memberInput, rules, configurationFilePath);
+                memberInput.archiveGlob.reset();
+
+                if (auto const it = positions.find(memberInput.key); it != positions.end())
+                {
+                    result[it->second] = std::move(memberInput);
+                    continue;
+                }
+
+                positions.emplace(memberInput.key, result.size());
+                result.emplace_back(std::move(memberInput));
+            }
+        }
+
+        return result;
+    }
+
     Configuration parseConfiguration(std::unique_ptr<FileSystem> const& fileSystem, std::istream& stream,
                                      std::filesystem::path const& configurationFilePath)
     {
         std::string lineBuffer;
         size_t linePosition = 1u;
         std::vector<Input> inputs;
+        std::vector<std::string> inputOptions;
+        std::vector<OptionsRule> rules;
+        std::vector<VariantDimension> dimensions;
+        std::vector<VariantGroup> variantGroups;
+        std::optional<std::size_t> runtimeCacheBudget;
+        std::size_t inlineThreshold = 0u;
+        bool externalArchive = false;
+        std::optional<std::string> overlayPath;
 
         while (std::getline(stream, lineBuffer))
         {
-            auto const fileName = cleanLine(lineBuffer, OneLineCommentStart);
+            auto const cleanedLine = cleanLine(lineBuffer, OneLineCommentStart);
+            auto const separatorPosition = cleanedLine.find(OptionsSeparator);
+            auto const fileName = trim(cleanedLine.substr(0u, separatorPosition));
+            auto const options = separatorPosition != std::string_view::npos ? cleanedLine.substr(separatorPosition + 1u) : std::string_view{};
+
+            if (startsWith(fileName, DimensionDirective))
+            {
+                auto dimension = parseDimension(trim(fileName.substr(DimensionDirective.size())), options, linePosition, configurationFilePath);
+
+                for (auto const& other : dimensions)
+                {
+                    if (other.name == dimension.name)
+                        throw std::runtime_error(format("{}:{}: dimension '{}' already declared line {}", configurationFilePath.generic_string(), linePosition, dimension.name, other.line));
+                }
+
+                dimensions.emplace_back(std::move(dimension));
+            }
+            else if (startsWith(fileName, VariantsDirective))
+            {
+                auto group = parseVariantGroup(trim(cleanedLine.substr(VariantsDirective.size())), dimensions, linePosition, configurationFilePath);
+
+                for (auto const& other : variantGroups)
+                {
+                    if (other.key == group.key)
+                        throw std::runtime_error(format("{}:{}: variants '{}' already declared line {}", configurationFilePath.generic_string(), linePosition, group.key, other.line));
+                }
+
+                variantGroups.emplace_back(std::move(group));
+            }
+            else if (startsWith(fileName, InlineDirective))
+            {
+                auto const threshold = trim(fileName.substr(InlineDirective.size()));
+                auto const value = threshold.empty() ? std::optional<std::size_t>{DefaultInlineThreshold} : parseByteSize(threshold);
+
+                if (!value.has_value() || *value == 0u || *value > MaxInlineThreshold)
+                    throw std::runtime_error(format("{}:{}: invalid inline threshold '{}', expected at most {} bytes", configurationFilePath.generic_string(), linePosition, threshold, MaxInlineThreshold));
+
+                inlineThreshold = *value;
+            }
+            else if (startsWith(fileName, CachedDirective))
+            {
+                auto const budget = trim(fileName.substr(CachedDirective.size()));
+
+                runtimeCacheBudget = budget.empty() ? std::optional<std::size_t>{DefaultCacheBudget} : parseByteSize(budget);
 
-            if (!fileName.empty())
+                if (!runtimeCacheBudget.has_value())
+                    throw std::runtime_error(format("{}:{}: invalid cache budget '{}'", configurationFilePath.generic_string(), linePosition, budget));
+            }
+            else if (startsWith(fileName, ArchiveDirective))
+            {
+                auto const arguments = trim(fileName.substr(ArchiveDirective.size()));
+
+                if (!arguments.empty())
+                    throw std::runtime_error(format("{}:{}: unexpected '{}' after {}", configurationFilePath.generic_string(), linePosition, arguments, ArchiveDirective));
+
+                externalArchive = true;
+            }
+            else if (startsWith(fileName, OverlayDirective))
+            {
+                auto const path = trim(fileName.substr(OverlayDirective.size()));
+
+                if (path.empty())
+                    throw std::runtime_error(format("{}:{}: path expected after {}", configurationFilePath.generic_string(), linePosition, OverlayDirective));
+
+                overlayPath = std::string{path};
+            }
+            else if (startsWith(fileName, OptionsDirective))
+            {
+                auto const pattern = trim(fileName.substr(OptionsDirective.size()));
+
+                if (pattern.empty())
+                    throw std::runtime_error(format("{}:{}: pattern expected after {}", configurationFilePath.generic_string(), linePosition, OptionsDirective));
+
+                rules.push_back(OptionsRule{std::string{pattern}, std::string{options}, linePosition});
+            }
+            else if (!fileName.empty())
             {
                 auto const configurationDirectory = configurationFilePath.parent_path();
                 auto const absoluteInputPath{configurationDirectory / fileName};
@@ -59,12 +486,38 @@ namespace
                 checkResourceFile(fileSystem, input, configurationFilePath);
 
                 inputs.emplace_back(std::move(input));
+                inputOptions.emplace_back(options);
             }
 
             ++linePosition;
         }
 
-        return Configuration{configurationFilePath, inputs};
+        // The options of the rules are applied first, in order of declaration, then the options of the input itself.
+        for (auto i = 0u; i < inputs.size(); ++i)
+        {
+            applyRules(inputs[i], rules, configurationFilePath);
+            parseOptions(inputs[i], inputOptions[i], inputs[i].line, configurationFilePath);
+        }
+
+        inputs = expandArchives(fileSystem, std::move(inputs), rules, configurationFilePath);
+
+        for (auto const& input : inputs)
+        {
+            // The other options need the content of the resource to be accessible directly.
+            if (input.frameSize > 0u && (input.lineIndex || input.json || !input.columnTypes.empty() || input.dictionaryType != DictionaryType::None))
+                throw std::runtime_error(format("{}:{}: option 'compress' can not be combined with options lines, csv, json, map and set", configurationFilePath.generic_string(), input.line));
+        }
+
+        Configuration configuration{configurationFilePath, inputs};
+
+        configuration.dimensions = std::move(dimensions);
+        configuration.variantGroups = std::move(variantGroups);
+        configuration.runtimeCacheBudget = runtimeCacheBudget;
+        configuration.inlineThreshold = inlineThreshold;
+        configuration.externalArchive = externalArchive;
+        configuration.overlayPath = overlayPath;
+
+        return configuration;
     }
 }
 
@@ -110,5 +563,11 @@ Configuration ConfigurationParser::parseStream(std::istream& stream, std::filesy
                                            [](Input const& left, Input const& right) { return left.key == right.key; }),
                                configuration.inputs.end());
 
+    // The groups of variants are also searched using a binary search.
+    std::sort(configuration.variantGroups.begin(), configuration.variantGroups.end(), [](VariantGroup const& left, VariantGroup const& right)
+    {
+        return left.key < right.key;
+    });
+
     return configuration;
 }
\ No newline at end of file
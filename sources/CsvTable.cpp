@@ -0,0 +1,190 @@
+#include "CsvTable.hpp"
+#include "StringHelpers.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace
+{
+    struct ColumnTypeInfo
+    {
+        ColumnType type;
+        char const* name;
+        char const* cppType;
+    };
+
+    static constexpr ColumnTypeInfo const ColumnTypes[] = {
+        {ColumnType::Int8, "int8", "std::int8_t"},
+        {ColumnType::Int16, "int16", "std::int16_t"},
+        {ColumnType::Int32, "int32", "std::int32_t"},
+        {ColumnType::Int64, "int64", "std::int64_t"},
+        {ColumnType::UInt8, "uint8", "std::uint8_t"},
+        {ColumnType::UInt16, "uint16", "std::uint16_t"},
+        {ColumnType::UInt32, "uint32", "std::uint32_t"},
+        {ColumnType::UInt64, "uint64", "std::uint64_t"},
+        {ColumnType::Float, "float", "float"},
+        {ColumnType::Double, "double", "double"},
+    };
+
+    ColumnTypeInfo const& getInfo(ColumnType type)
+    {
+        return ColumnTypes[static_cast<std::size_t>(type)];
+    }
+
+    template <typename T>
+    std::optional<std::string> toIntegerLiteral(std::string_view text)
+    {
+        using ParsedType = std::conditional_t<std::is_signed_v<T>, std::int64_t, std::uint64_t>;
+        ParsedType value{};
+
+        if (!text.empty() && text.front() == '+')
+            text.remove_prefix(1u);
+
+        auto const [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+
+        if (error != std::errc{} || end != text.data() + text.size())
+            return {};
+
+        if (value < std::numeric_limits<T>::min() || value > std::numeric_limits<T>::max())
+            return {};
+
+        // The literal -9223372036854775808 does not exist in C++: it's the negation of a value too big for any signed type.
+        if constexpr (std::is_same_v<T, std::int64_t>)
+        {
+            if (value == std::numeric_limits<std::int64_t>::min())
+                return format("({} - 1)", std::numeric_limits<std::int64_t>::min() + 1);
+        }
+
+        return std::is_signed_v<T> ? std::to_string(value) : std::to_string(value) + "u";
+    }
+
+    template <typename T>
+    std::optional<std::string> toFloatingPointLiteral(std::string_view text)
+    {
+        std::string const nullTerminated{text};
+        char* end = nullptr;
+        T const value = std::is_same_v<T, float> ? std::strtof(nullTerminated.c_str(), &end) : std::strtod(nullTerminated.c_str(), &end);
+
+        if (nullTerminated.empty() || end != nullTerminated.c_str() + nullTerminated.size() || !std::isfinite(value))
+            return {};
+
+        // Hexadecimal floating point literals represent exactly the parsed value.
+        std::ostringstream stream;
+
+        stream << std::hexfloat << value;
+
+        return std::is_same_v<T, float> ? stream.str() + "f" : stream.str();
+    }
+
+    std::optional<std::string> toLiteral(ColumnType type, std::string_view text)
+    {
+        switch (type)
+        {
+            case ColumnType::Int8: return toIntegerLiteral<std::int8_t>(text);
+            case ColumnType::Int16: return toIntegerLiteral<std::int16_t>(text);
+            case ColumnType::Int32: return toIntegerLiteral<std::int32_t>(text);
+            case ColumnType::Int64: return toIntegerLiteral<std::int64_t>(text);
+            case ColumnType::UInt8: return toIntegerLiteral<std::uint8_t>(text);
+            case ColumnType::UInt16: return toIntegerLiteral<std::uint16_t>(text);
+            case ColumnType::UInt32: return toIntegerLiteral<std::uint32_t>(text);
+            case ColumnType::UInt64: return toIntegerLiteral<std::uint64_t>(text);
+            case ColumnType::Float: return toFloatingPointLiteral<float>(text);
+            case ColumnType::Double: return toFloatingPointLiteral<double>(text);
+        }
+
+        return {};
+    }
+
+    std::vector<std::string_view> splitCells(std::string_view line)
+    {
+        auto cells = split(line, ',');
+
+        for (auto& cell : cells)
+            cell = trim(cell);
+
+        return cells;
+    }
+
+    std::string_view unquote(std::string_view cell)
+    {
+        if (cell.size() >= 2u && cell.front() == '"' && cell.back() == '"')
+            return cell.substr(1u, cell.size() - 2u);
+
+        return cell;
+    }
+}
+
+std::optional<ColumnType> toColumnType(std::string_view name)
+{
+    for (auto const& info : ColumnTypes)
+    {
+        if (name == info.name)
+            return info.type;
+    }
+
+    return {};
+}
+
+std::string toString(ColumnType type)
+{
+    return getInfo(type).name;
+}
+
+std::string toCppType(ColumnType type)
+{
+    return getInfo(type).cppType;
+}
+
+std::vector<CsvColumn> parseCsvTable(std::vector<char> const& buffer, std::vector<ColumnType> const& types, bool hasHeader)
+{
+    std::vector<CsvColumn> columns;
+    std::string_view text{buffer.data(), buffer.size()};
+    std::size_t lineNumber = 0u;
+    bool isHeader = hasHeader;
+
+    for (auto type : types)
+        columns.push_back(CsvColumn{{}, type, {}});
+
+    while (!text.empty())
+    {
+        auto const lineEnd = std::min(text.find('\n'), text.size());
+        auto const line = trim(text.substr(0u, lineEnd));
+
+        text.remove_prefix(std::min(lineEnd + 1u, text.size()));
+        ++lineNumber;
+
+        if (line.empty())
+            continue;
+
+        auto const cells = splitCells(line);
+
+        if (cells.size() != types.size())
+            throw std::runtime_error(format("line {}: {} columns expected but {} found", lineNumber, types.size(), cells.size()));
+
+        if (isHeader)
+        {
+            for (auto i = 0u; i < cells.size(); ++i)
+                columns[i].name = unquote(cells[i]);
+
+            isHeader = false;
+            continue;
+        }
+
+        for (auto i = 0u; i < cells.size(); ++i)
+        {
+            auto literal = toLiteral(types[i], cells[i]);
+
+            if (!literal.has_value())
+                throw std::runtime_error(format("line {}: column {}: '{}' is not a valid {}", lineNumber, i + 1u, cells[i], toString(types[i])));
+
+            columns[i].values.push_back(std::move(*literal));
+        }
+    }
+
+    return columns;
+}
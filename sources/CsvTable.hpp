@@ -0,0 +1,44 @@
+#ifndef RESCOM_CSVTABLE_HPP
+#define RESCOM_CSVTABLE_HPP
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Type of a column of a CSV table.
+enum class ColumnType
+{
+    Int8,
+    Int16,
+    Int32,
+    Int64,
+    UInt8,
+    UInt16,
+    UInt32,
+    UInt64,
+    Float,
+    Double,
+};
+
+/// Returns the column type named 'name' (int8, int16, int32, int64, uint8, uint16, uint32, uint64, float or double).
+std::optional<ColumnType> toColumnType(std::string_view name);
+/// Returns the name of the column type, as accepted by toColumnType().
+std::string toString(ColumnType type);
+/// Returns the C++ type used to store a value of this type.
+std::string toCppType(ColumnType type);
+
+struct CsvColumn
+{
+    /// The name of the column, empty if the table has no header.
+    std::string name;
+    ColumnType type;
+    /// The values as C++ literals.
+    std::vector<std::string> values;
+};
+
+/// Parse a CSV table of numeric values.
+/// The values are separated by commas, empty lines are ignored. If 'hasHeader' is true the first line names the columns.
+/// Throws std::runtime_error if a value is invalid or if a line does not have the expected count of columns.
+std::vector<CsvColumn> parseCsvTable(std::vector<char> const& buffer, std::vector<ColumnType> const& types, bool hasHeader);
+
+#endif //RESCOM_CSVTABLE_HPP
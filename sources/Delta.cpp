@@ -0,0 +1,444 @@
+#include "Delta.hpp"
+#include "StringHelpers.hpp"
+
+#include <picosha2.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+    static constexpr std::string_view const Magic = "RSCD";
+    static constexpr unsigned char const Version = 1u;
+    static constexpr std::size_t const DigestSize = 32u;
+    static constexpr std::size_t const MinBlockSize = 16u;
+    static constexpr std::size_t const MaxBlockSize = 4096u;
+
+    enum class EntryKind : unsigned char
+    {
+        Copy = 0u,
+        Literal = 1u,
+        Delta = 2u,
+    };
+
+    enum class Operation : unsigned char
+    {
+        Insert = 0u,
+        Copy = 1u,
+    };
+
+    using Digest = std::vector<unsigned char>;
+
+    Digest makeDigest(std::vector<char> const& content)
+    {
+        Digest digest(DigestSize);
+
+        picosha2::hash256(content.begin(), content.end(), digest.begin(), digest.end());
+
+        return digest;
+    }
+
+    void writeVarint(std::vector<char>& output, std::uint64_t value)
+    {
+        for (; value >= 0x80u; value >>= 7u)
+            output.push_back(static_cast<char>((value & 0x7Fu) | 0x80u));
+
+        output.push_back(static_cast<char>(value));
+    }
+
+    void writeBytes(std::vector<char>& output, char const* bytes, std::size_t size)
+    {
+        output.insert(output.end(), bytes, bytes + size);
+    }
+
+    void writeString(std::vector<char>& output, std::string const& text)
+    {
+        writeVarint(output, text.size());
+        writeBytes(output, text.data(), text.size());
+    }
+
+    void writeDigest(std::vector<char>& output, Digest const& digest)
+    {
+        output.insert(output.end(), digest.begin(), digest.end());
+    }
+
+    /// Read the patch, throws std::runtime_error if the patch is truncated.
+    class PatchReader
+    {
+        std::vector<char> const& _patch;
+        std::size_t _position = 0u;
+    public:
+        explicit PatchReader(std::vector<char> const& patch) : _patch(patch) {}
+
+        bool atEnd() const { return _position == _patch.size(); }
+
+        char const* read(std::size_t size)
+        {
+            if (size > _patch.size() - _position)
+                throw std::runtime_error("invalid patch: truncated");
+
+            auto const* bytes = _patch.data() + _position;
+
+            _position += size;
+            return bytes;
+        }
+
+        unsigned char readByte() { return static_cast<unsigned char>(*read(1u)); }
+
+        std::uint64_t readVarint()
+        {
+            std::uint64_t value = 0u;
+
+            for (auto shift = 0u; shift < 64u; shift += 7u)
+            {
+                auto const byte = readByte();
+
+                value |= static_cast<std::uint64_t>(byte & 0x7Fu) << shift;
+                if ((byte & 0x80u) == 0u)
+                    return value;
+            }
+
+            throw std::runtime_error("invalid patch: invalid integer");
+        }
+
+        std::size_t readSize() { return static_cast<std::size_t>(readVarint()); }
+
+        std::string readString()
+        {
+            auto const size = readSize();
+            auto const* bytes = read(size);
+
+            return std::string(bytes, size);
+        }
+
+        Digest readDigest()
+        {
+            auto const* bytes = reinterpret_cast<unsigned char const*>(read(DigestSize));
+
+            return Digest(bytes, bytes + DigestSize);
+        }
+    };
+
+    /// Digest of a whole set: the keys and the digests of the contents, in order.
+    Digest makeSetDigest(ResourceSet const& resources)
+    {
+        std::vector<char> buffer;
+
+        for (auto const& [key, content] : resources)
+        {
+            writeString(buffer, key);
+            writeDigest(buffer, makeDigest(content));
+        }
+
+        return makeDigest(buffer);
+    }
+
+    /// Rolling checksum of rsync: 'a' is the sum of the bytes, 'b' the sum of the sums.
+    class RollingHash
+    {
+        std::uint32_t _a = 0u;
+        std::uint32_t _b = 0u;
+        std::uint32_t _size = 0u;
+    public:
+        RollingHash(char const* bytes, std::size_t size)
+        : _size(static_cast<std::uint32_t>(size))
+        {
+            for (auto i = 0u; i < size; ++i)
+            {
+                _a += static_cast<unsigned char>(bytes[i]);
+                _b += _a;
+            }
+        }
+
+        void roll(char removed, char added)
+        {
+            _a += static_cast<std::uint32_t>(static_cast<unsigned char>(added)) - static_cast<unsigned char>(removed);
+            _b += _a - _size * static_cast<unsigned char>(removed);
+        }
+
+        std::uint32_t value() const { return (_a & 0xFFFFu) | (_b << 16u); }
+    };
+
+    std::size_t selectBlockSize(std::size_t size)
+    {
+        auto const root = static_cast<std::size_t>(std::sqrt(static_cast<double>(size)));
+
+        return std::clamp(root, MinBlockSize, MaxBlockSize);
+    }
+
+    struct Operations
+    {
+        std::vector<char> data;
+        std::size_t count = 0u;
+    };
+
+    /// Encode 'newContent' as a sequence of copies of 'oldContent' and insertions of new bytes.
+    Operations encodeOperations(std::vector<char> const& oldContent, std::vector<char> const& newContent)
+    {
+        auto const blockSize = selectBlockSize(oldContent.size());
+        std::unordered_map<std::uint32_t, std::vector<std::size_t>> blocks;
+        Operations operations;
+        std::size_t pending = 0u;
+        std::size_t copyOffset = 0u;
+        std::size_t copyLength = 0u;
+
+        auto const flushCopy = [&]()
+        {
+            if (copyLength == 0u)
+                return;
+
+            operations.data.push_back(static_cast<char>(Operation::Copy));
+            writeVarint(operations.data, copyOffset);
+            writeVarint(operations.data, copyLength);
+            ++operations.count;
+            copyLength = 0u;
+        };
+
+        auto const flushInsert = [&](std::size_t end)
+        {
+            if (end == pending)
+                return;
+
+            flushCopy();
+            operations.data.push_back(static_cast<char>(Operation::Insert));
+            writeVarint(operations.data, end - pending);
+            writeBytes(operations.data, newContent.data() + pending, end - pending);
+            ++operations.count;
+        };
+
+        for (std::size_t offset = 0u; offset + blockSize <= oldContent.size(); offset += blockSize)
+            blocks[RollingHash{oldContent.data() + offset, blockSize}.value()].push_back(offset);
+
+        std::size_t i = 0u;
+
+        while (!blocks.empty() && i + blockSize <= newContent.size())
+        {
+            RollingHash hash{newContent.data() + i, blockSize};
+            std::optional<std::size_t> match;
+
+            for (; i + blockSize <= newContent.size(); ++i)
+            {
+                if (auto const it = blocks.find(hash.value()); it != blocks.end())
+                {
+                    auto const found = std::find_if(it->second.begin(), it->second.end(), [&](std::size_t offset)
+                    {
+                        return std::memcmp(oldContent.data() + offset, newContent.data() + i, blockSize) == 0;
+                    });
+
+                    if (found != it->second.end())
+                    {
+                        match = *found;
+                        break;
+                    }
+                }
+
+                if (i + blockSize < newContent.size())
+                    hash.roll(newContent[i], newContent[i + blockSize]);
+            }
+
+            if (!match.has_value())
+                break;
+
+            // The match is extended as far as the contents are equal, block boundaries don't matter.
+            auto length = blockSize;
+
+            while (*match + length < oldContent.size() && i + length < newContent.size() && oldContent[*match + length] == newContent[i + length])
+                ++length;
+
+            flushInsert(i);
+            if (copyLength > 0u && copyOffset + copyLength == *match)
+            {
+                copyLength += length;
+            }
+            else
+            {
+                flushCopy();
+                copyOffset = *match;
+                copyLength = length;
+            }
+
+            i += length;
+            pending = i;
+        }
+
+        flushInsert(newContent.size());
+        flushCopy();
+
+        return operations;
+    }
+
+    std::vector<char> decodeOperations(PatchReader& reader, std::vector<char> const& oldContent, std::size_t size)
+    {
+        std::vector<char> content;
+        auto const operationCount = reader.readVarint();
+
+        for (std::uint64_t i = 0u; i < operationCount; ++i)
+        {
+            auto const operation = static_cast<Operation>(reader.readByte());
+
+            if (operation == Operation::Insert)
+            {
+                auto const length = reader.readSize();
+                auto const* bytes = reader.read(length);
+
+                content.insert(content.end(), bytes, bytes + length);
+            }
+            else if (operation == Operation::Copy)
+            {
+                auto const offset = reader.readSize();
+                auto const length = reader.readSize();
+
+                if (offset > oldContent.size() || length > oldContent.size() - offset)
+                    throw std::runtime_error("invalid patch: copy out of the old resource");
+
+                content.insert(content.end(), oldContent.begin() + static_cast<std::ptrdiff_t>(offset), oldContent.begin() + static_cast<std::ptrdiff_t>(offset + length));
+            }
+            else
+            {
+                throw std::runtime_error("invalid patch: unknown operation");
+            }
+        }
+
+        if (content.size() != size)
+            throw std::runtime_error("invalid patch: invalid size");
+
+        return content;
+    }
+}
+
+std::vector<char> makeDelta(ResourceSet const& oldResources, ResourceSet const& newResources)
+{
+    std::vector<char> patch(Magic.begin(), Magic.end());
+    std::map<Digest, std::string> oldKeysByDigest;
+    std::vector<std::string> removedKeys;
+    std::vector<char> entries;
+    std::size_t entryCount = 0u;
+
+    patch.push_back(static_cast<char>(Version));
+    writeDigest(patch, makeSetDigest(oldResources));
+
+    for (auto const& [key, content] : oldResources)
+    {
+        oldKeysByDigest.emplace(makeDigest(content), key);
+
+        if (newResources.find(key) == newResources.end())
+            removedKeys.push_back(key);
+    }
+
+    for (auto const& [key, content] : newResources)
+    {
+        auto const digest = makeDigest(content);
+        auto const old = oldResources.find(key);
+
+        if (old != oldResources.end() && old->second == content)
+            continue;
+
+        writeString(entries, key);
+
+        if (auto const source = oldKeysByDigest.find(digest); source != oldKeysByDigest.end())
+        {
+            entries.push_back(static_cast<char>(EntryKind::Copy));
+            writeString(entries, source->second);
+        }
+        else if (auto const operations = old != oldResources.end() ? encodeOperations(old->second, content) : Operations{};
+                 operations.count > 0u && operations.data.size() < content.size())
+        {
+            entries.push_back(static_cast<char>(EntryKind::Delta));
+            writeVarint(entries, content.size());
+            writeVarint(entries, operations.count);
+            writeBytes(entries, operations.data.data(), operations.data.size());
+        }
+        else
+        {
+            entries.push_back(static_cast<char>(EntryKind::Literal));
+            writeVarint(entries, content.size());
+            writeBytes(entries, content.data(), content.size());
+        }
+
+        writeDigest(entries, digest);
+        ++entryCount;
+    }
+
+    writeVarint(patch, removedKeys.size());
+    for (auto const& key : removedKeys)
+        writeString(patch, key);
+
+    writeVarint(patch, entryCount);
+    writeBytes(patch, entries.data(), entries.size());
+
+    return patch;
+}
+
+ResourceSet applyDelta(ResourceSet const& oldResources, std::vector<char> const& patch)
+{
+    PatchReader reader{patch};
+
+    if (std::string_view{reader.read(Magic.size()), Magic.size()} != Magic || reader.readByte() != Version)
+        throw std::runtime_error("invalid patch: unknown format");
+
+    if (reader.readDigest() != makeSetDigest(oldResources))
+        throw std::runtime_error("the patch was made for another set of resources");
+
+    ResourceSet resources = oldResources;
+    auto const removedCount = reader.readVarint();
+
+    for (std::uint64_t i = 0u; i < removedCount; ++i)
+        resources.erase(reader.readString());
+
+    auto const entryCount = reader.readVarint();
+
+    for (std::uint64_t i = 0u; i < entryCount; ++i)
+    {
+        auto const key = reader.readString();
+        auto const kind = static_cast<EntryKind>(reader.readByte());
+        std::vector<char> content;
+
+        if (kind == EntryKind::Copy)
+        {
+            auto const source = oldResources.find(reader.readString());
+
+            if (source == oldResources.end())
+                throw std::runtime_error(format("invalid patch: source of '{}' not found", key));
+
+            content = source->second;
+        }
+        else if (kind == EntryKind::Literal)
+        {
+            auto const size = reader.readSize();
+            auto const* bytes = reader.read(size);
+
+            content.assign(bytes, bytes + size);
+        }
+        else if (kind == EntryKind::Delta)
+        {
+            auto const old = oldResources.find(key);
+            auto const size = reader.readSize();
+
+            if (old == oldResources.end())
+                throw std::runtime_error(format("invalid patch: '{}' not found", key));
+
+            content = decodeOperations(reader, old->second, size);
+        }
+        else
+        {
+            throw std::runtime_error("invalid patch: unknown entry");
+        }
+
+        if (reader.readDigest() != makeDigest(content))
+            throw std::runtime_error(format("invalid patch: content of '{}' does not match", key));
+
+        resources[key] = std::move(content);
+    }
+
+    if (!reader.atEnd())
+        throw std::runtime_error("invalid patch: unexpected data at the end");
+
+    return resources;
+}
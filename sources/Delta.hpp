@@ -0,0 +1,22 @@
+#ifndef RESCOM_DELTA_HPP
+#define RESCOM_DELTA_HPP
+#include "ResourceSet.hpp"
+
+#include <vector>
+
+/// \brief Patch transforming a set of resources into another one
+/// Entries are compared by key and content. The unchanged entries are not stored in the patch, so its size depends
+/// only on what changed. A changed entry is stored as one of:
+/// - a copy of an entry of the old set having another key (renamed file),
+/// - a delta against the entry of the old set having the same key,
+/// - its whole content, when it's smaller than the delta.
+/// Deltas are computed like rsync: the blocks of the old content are indexed by a rolling hash, then the new content
+/// is scanned to find them. The patch also stores a digest of the old set and of each new entry, so applying a patch
+/// to the wrong set fails instead of producing corrupted resources.
+std::vector<char> makeDelta(ResourceSet const& oldResources, ResourceSet const& newResources);
+
+/// Rebuild the new set of resources from the old one.
+/// Throws std::runtime_error if the patch is invalid or was not made for 'oldResources'.
+ResourceSet applyDelta(ResourceSet const& oldResources, std::vector<char> const& patch);
+
+#endif //RESCOM_DELTA_HPP
@@ -0,0 +1,178 @@
+#include "Dictionary.hpp"
+#include "StringHelpers.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_set>
+
+namespace
+{
+    static constexpr char const* const CommentStart = "#";
+    /// Average count of keys per bucket. Bigger buckets make the table smaller but longer to build.
+    static constexpr std::size_t const KeysPerBucket = 4u;
+    static constexpr std::uint32_t const MaximumSeed = 1u << 16u;
+
+    /// Call 'function' for each line not empty and not commented.
+    template <typename Function>
+    void forEachLine(std::vector<char> const& buffer, Function&& function)
+    {
+        std::string_view text{buffer.data(), buffer.size()};
+        std::size_t lineNumber = 0u;
+
+        while (!text.empty())
+        {
+            auto const lineEnd = std::min(text.find('\n'), text.size());
+            auto const line = trim(text.substr(0u, lineEnd));
+
+            text.remove_prefix(std::min(lineEnd + 1u, text.size()));
+            ++lineNumber;
+
+            if (!line.empty() && line.find(CommentStart) != 0u)
+                function(line, lineNumber);
+        }
+    }
+
+    std::string unescape(std::string_view text, std::size_t lineNumber)
+    {
+        std::string result;
+
+        for (auto i = 0u; i < text.size(); ++i)
+        {
+            if (text[i] != '\\')
+            {
+                result.push_back(text[i]);
+                continue;
+            }
+
+            if (++i == text.size())
+                throw std::runtime_error(format("line {}: incomplete escape sequence", lineNumber));
+
+            switch (text[i])
+            {
+                case 'n': result.push_back('\n'); break;
+                case 't': result.push_back('\t'); break;
+                case '\\': result.push_back('\\'); break;
+                default:
+                    throw std::runtime_error(format("line {}: invalid escape sequence '\\{}'", lineNumber, std::string(1u, text[i])));
+            }
+        }
+
+        return result;
+    }
+
+    /// Try to find a table with 'slotCount' slots, returns false if a bucket can't be placed.
+    bool tryBuild(std::vector<DictionaryEntry> const& entries, std::size_t slotCount, PerfectHashTable& table)
+    {
+        auto const bucketCount = std::max<std::size_t>(1u, entries.size() / KeysPerBucket);
+        std::vector<std::vector<int>> buckets(bucketCount);
+
+        for (auto i = 0u; i < entries.size(); ++i)
+            buckets[hashKey(entries[i].key, 0u) % bucketCount].push_back(static_cast<int>(i));
+
+        // Place the biggest buckets first, while the table is still mostly empty.
+        std::vector<std::size_t> order(bucketCount);
+
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [&buckets](auto left, auto right) { return buckets[left].size() > buckets[right].size(); });
+
+        table.seeds.assign(bucketCount, 0u);
+        table.slots.assign(slotCount, -1);
+
+        std::vector<std::size_t> candidateSlots;
+
+        for (auto const bucketIndex : order)
+        {
+            auto const& bucket = buckets[bucketIndex];
+
+            if (bucket.empty())
+                break;
+
+            bool placed = false;
+
+            for (auto seed = 1u; seed < MaximumSeed && !placed; ++seed)
+            {
+                candidateSlots.clear();
+                placed = true;
+
+                for (auto const entryIndex : bucket)
+                {
+                    auto const slot = hashKey(entries[entryIndex].key, seed) % slotCount;
+
+                    if (table.slots[slot] != -1 || std::find(candidateSlots.begin(), candidateSlots.end(), slot) != candidateSlots.end())
+                    {
+                        placed = false;
+                        break;
+                    }
+
+                    candidateSlots.push_back(slot);
+                }
+
+                if (placed)
+                {
+                    table.seeds[bucketIndex] = seed;
+
+                    for (auto i = 0u; i < bucket.size(); ++i)
+                        table.slots[candidateSlots[i]] = bucket[i];
+                }
+            }
+
+            if (!placed)
+                return false;
+        }
+
+        return true;
+    }
+}
+
+std::vector<DictionaryEntry> parseKeyValues(std::vector<char> const& buffer)
+{
+    std::vector<DictionaryEntry> entries;
+    std::unordered_set<std::string> keys;
+
+    forEachLine(buffer, [&entries, &keys](std::string_view line, std::size_t lineNumber)
+    {
+        auto const equalPosition = line.find('=');
+
+        if (equalPosition == std::string_view::npos)
+            throw std::runtime_error(format("line {}: '=' expected", lineNumber));
+
+        auto key = std::string{trim(line.substr(0u, equalPosition))};
+
+        if (key.empty())
+            throw std::runtime_error(format("line {}: empty key", lineNumber));
+
+        if (!keys.insert(key).second)
+            throw std::runtime_error(format("line {}: duplicate key '{}'", lineNumber, key));
+
+        entries.push_back(DictionaryEntry{std::move(key), unescape(trim(line.substr(equalPosition + 1u)), lineNumber)});
+    });
+
+    return entries;
+}
+
+std::vector<DictionaryEntry> parseWords(std::vector<char> const& buffer)
+{
+    std::vector<DictionaryEntry> entries;
+    std::unordered_set<std::string> words;
+
+    forEachLine(buffer, [&entries, &words](std::string_view line, std::size_t)
+    {
+        if (words.insert(std::string{line}).second)
+            entries.push_back(DictionaryEntry{std::string{line}, {}});
+    });
+
+    return entries;
+}
+
+PerfectHashTable buildPerfectHashTable(std::vector<DictionaryEntry> const& entries)
+{
+    PerfectHashTable table;
+
+    // A few empty slots make the table much faster to build, add more if it's not enough.
+    for (auto slotCount = std::max<std::size_t>(1u, entries.size() + entries.size() / 16u); ; slotCount += slotCount / 8u + 1u)
+    {
+        if (tryBuild(entries, slotCount, table))
+            return table;
+    }
+}
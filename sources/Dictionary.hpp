@@ -0,0 +1,65 @@
+#ifndef RESCOM_DICTIONARY_HPP
+#define RESCOM_DICTIONARY_HPP
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class DictionaryType
+{
+    None,
+    /// One pair key=value per line
+    Map,
+    /// One word per line
+    Set,
+};
+
+struct DictionaryEntry
+{
+    std::string key;
+    std::string value;
+};
+
+/// Parse lines 'key=value'. Spaces around keys and values are ignored, as empty lines and lines starting by '#'.
+/// Values support the escape sequences \n, \t and \\.
+/// Throws std::runtime_error if a line is invalid or if a key is defined twice.
+std::vector<DictionaryEntry> parseKeyValues(std::vector<char> const& buffer);
+
+/// Parse one word per line. Spaces around words are ignored, as empty lines and lines starting by '#'.
+/// Duplicated words are ignored.
+std::vector<DictionaryEntry> parseWords(std::vector<char> const& buffer);
+
+/// Hash function used by the perfect hash tables, the generated code must use exactly the same function.
+/// It's FNV-1a with a seed, followed by the finalizer of MurmurHash3 to improve the distribution of the low bits.
+constexpr std::uint32_t hashKey(std::string_view key, std::uint32_t seed)
+{
+    std::uint32_t hash = 2166136261u ^ seed;
+
+    for (auto const c : key)
+    {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+
+    hash ^= hash >> 16u;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13u;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16u;
+
+    return hash;
+}
+
+/// \brief Perfect hash table using the "hash and displace" method
+/// The slot of a key is hashKey(key, seeds[hashKey(key, 0) % seeds.size()]) % slots.size().
+/// Each key has its own slot, a lookup is one comparison of key.
+struct PerfectHashTable
+{
+    std::vector<std::uint32_t> seeds;
+    /// Index of the key stored in each slot, -1 if the slot is empty.
+    std::vector<int> slots;
+};
+
+PerfectHashTable buildPerfectHashTable(std::vector<DictionaryEntry> const& entries);
+
+#endif //RESCOM_DICTIONARY_HPP
@@ -2,6 +2,7 @@
 #include "StringHelpers.hpp"
 #include <fstream>
 #include <iterator>
+#include <random>
 
 //
 // class LocalFileSystem
@@ -35,6 +36,18 @@ void LocalFileSystem::getContent(std::filesystem::path const& path, std::vector<
     }
 }
 
+void LocalFileSystem::getContent(std::filesystem::path const& path, std::uint64_t offset, std::size_t size, std::vector<char>& buffer) const
+{
+    std::ifstream file{path, std::ios::binary};
+
+    buffer.resize(size);
+
+    if (!file.is_open() || !file.seekg(static_cast<std::streamoff>(offset)) || !file.read(buffer.data(), static_cast<std::streamsize>(size)))
+    {
+        throw std::runtime_error(format("unable to read {} bytes at offset {} of '{}'", size, offset, path.generic_string()));
+    }
+}
+
 //
 // class InMemoryFileSystem
 //
@@ -73,6 +86,23 @@ void InMemoryFileSystem::getContent(std::filesystem::path const& path, std::vect
     if (auto it = _files.find(path); it != _files.end())
     {
         buffer = it->second.buffer;
+        return;
+    }
+
+    throw std::range_error(format("file '{}' not found", path.generic_string()));
+}
+
+void InMemoryFileSystem::getContent(std::filesystem::path const& path, std::uint64_t offset, std::size_t size, std::vector<char>& buffer) const
+{
+    if (auto it = _files.find(path); it != _files.end())
+    {
+        auto const& content = it->second.buffer;
+
+        if (offset > content.size() || size > content.size() - offset)
+            throw std::range_error(format("unable to read {} bytes at offset {} of '{}'", size, offset, path.generic_string()));
+
+        buffer.assign(content.begin() + static_cast<std::ptrdiff_t>(offset), content.begin() + static_cast<std::ptrdiff_t>(offset + size));
+        return;
     }
 
     throw std::range_error(format("file '{}' not found", path.generic_string()));
@@ -82,3 +112,14 @@ void InMemoryFileSystem::add(std::filesystem::path const& path, std::vector<char
 {
     _files.emplace(path, FileInfo{exists, isRegularFile, std::move(buffer)});
 }
+
+std::filesystem::path makeTemporaryPath(std::filesystem::path const& path)
+{
+    std::random_device device;
+    std::uniform_int_distribution<unsigned long long> distribution;
+    auto temporaryPath = path;
+
+    temporaryPath += format(".{}.tmp", distribution(device));
+
+    return temporaryPath;
+}
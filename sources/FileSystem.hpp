@@ -1,5 +1,6 @@
 #ifndef RESCOM_FILESYSTEM_HPP
 #define RESCOM_FILESYSTEM_HPP
+#include <cstdint>
 #include <filesystem>
 #include <map>
 #include <vector>
@@ -13,6 +14,8 @@ public:
     virtual bool exists(std::filesystem::path const& path) const = 0;
     virtual bool isRegularFile(std::filesystem::path const& path) const = 0;
     virtual void getContent(std::filesystem::path const& path, std::vector<char>& buffer) const = 0;
+    /// Read 'size' bytes starting at 'offset'.
+    virtual void getContent(std::filesystem::path const& path, std::uint64_t offset, std::size_t size, std::vector<char>& buffer) const = 0;
 };
 
 /// Implementation using the local file system as data source.
@@ -23,6 +26,7 @@ public:
     bool exists(std::filesystem::path const& path) const override;
     bool isRegularFile(std::filesystem::path const& path) const override;
     void getContent(std::filesystem::path const& path, std::vector<char>& buffer) const override;
+    void getContent(std::filesystem::path const& path, std::uint64_t offset, std::size_t size, std::vector<char>& buffer) const override;
 };
 
 /// Implementation storing data in memory.
@@ -44,6 +48,11 @@ public:
     bool exists(std::filesystem::path const& path) const override;
     bool isRegularFile(std::filesystem::path const& path) const override;
     void getContent(std::filesystem::path const& path, std::vector<char>& buffer) const override;
+    void getContent(std::filesystem::path const& path, std::uint64_t offset, std::size_t size, std::vector<char>& buffer) const override;
 };
 
+/// Returns a path next to 'path', with a random suffix: the files written under this name then renamed to 'path'
+/// are not shared with another process doing the same.
+std::filesystem::path makeTemporaryPath(std::filesystem::path const& path);
+
 #endif //RESCOM_FILESYSTEM_HPP
@@ -0,0 +1,618 @@
+#include "Image.hpp"
+#include "Archive.hpp"
+#include "StringHelpers.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+
+namespace
+{
+    static constexpr unsigned char const Signature[] = {0x89u, 'P', 'N', 'G', '\r', '\n', 0x1Au, '\n'};
+    static constexpr unsigned int const MaxCodeLength = 15u;
+
+    /// Reads the bits of a deflate stream, least significant bit first.
+    class BitReader
+    {
+        unsigned char const* const _bytes;
+        std::size_t const _size;
+        std::size_t _position = 0u;
+        std::uint32_t _bits = 0u;
+        unsigned int _count = 0u;
+    public:
+        BitReader(unsigned char const* bytes, std::size_t size)
+        : _bytes(bytes)
+        , _size(size)
+        {
+        }
+
+        /// Read at most 16 bits.
+        unsigned int read(unsigned int count)
+        {
+            while (_count < count)
+            {
+                if (_position == _size)
+                    throw std::runtime_error("unexpected end of the compressed data");
+
+                _bits |= std::uint32_t{_bytes[_position++]} << _count;
+                _count += 8u;
+            }
+
+            auto const value = _bits & ((1u << count) - 1u);
+
+            _bits >>= count;
+            _count -= count;
+
+            return value;
+        }
+
+        /// Discard the bits remaining in the current byte.
+        void alignToByte()
+        {
+            read(_count % 8u);
+        }
+    };
+
+    /// Canonical Huffman code: count of codes of each length, and the symbols ordered by code.
+    struct HuffmanCode
+    {
+        std::array<std::uint16_t, MaxCodeLength + 1u> counts{};
+        std::vector<std::uint16_t> symbols;
+    };
+
+    /// Incomplete codes are allowed, a code using a single distance is valid.
+    HuffmanCode makeHuffmanCode(unsigned char const* lengths, std::size_t count)
+    {
+        HuffmanCode code;
+        std::array<std::uint16_t, MaxCodeLength + 2u> offsets{};
+        int left = 1;
+
+        code.symbols.resize(count);
+
+        for (auto i = 0u; i < count; ++i)
+            ++code.counts[lengths[i]];
+
+        for (auto length = 1u; length <= MaxCodeLength; ++length)
+        {
+            left = left * 2 - code.counts[length];
+
+            if (left < 0)
+                throw std::runtime_error("invalid Huffman code");
+        }
+
+        for (auto length = 1u; length <= MaxCodeLength; ++length)
+            offsets[length + 1u] = static_cast<std::uint16_t>(offsets[length] + code.counts[length]);
+
+        for (auto symbol = 0u; symbol < count; ++symbol)
+        {
+            if (lengths[symbol] != 0u)
+                code.symbols[offsets[lengths[symbol]]++] = static_cast<std::uint16_t>(symbol);
+        }
+
+        return code;
+    }
+
+    unsigned int decodeSymbol(BitReader& reader, HuffmanCode const& code)
+    {
+        int value = 0;
+        int first = 0;
+        int index = 0;
+
+        for (auto length = 1u; length <= MaxCodeLength; ++length)
+        {
+            value |= static_cast<int>(reader.read(1u));
+
+            int const count = code.counts[length];
+
+            if (value - count < first)
+                return code.symbols[static_cast<std::size_t>(index + value - first)];
+
+            index += count;
+            first = (first + count) << 1;
+            value <<= 1;
+        }
+
+        throw std::runtime_error("invalid Huffman code");
+    }
+
+    void inflateBlock(BitReader& reader, HuffmanCode const& literals, HuffmanCode const& distances,
+                      std::vector<unsigned char>& output, std::size_t maxSize)
+    {
+        static constexpr std::uint16_t const LengthBases[] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static constexpr std::uint8_t const LengthBits[] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        static constexpr std::uint16_t const DistanceBases[] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+        static constexpr std::uint8_t const DistanceBits[] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+        for (auto symbol = decodeSymbol(reader, literals); symbol != 256u; symbol = decodeSymbol(reader, literals))
+        {
+            if (symbol < 256u)
+            {
+                if (output.size() == maxSize)
+                    throw std::runtime_error("decompressed data too large");
+
+                output.push_back(static_cast<unsigned char>(symbol));
+                continue;
+            }
+
+            symbol -= 257u;
+
+            if (symbol >= std::size(LengthBases))
+                throw std::runtime_error("invalid length code");
+
+            std::size_t const length = LengthBases[symbol] + reader.read(LengthBits[symbol]);
+            auto const distanceSymbol = decodeSymbol(reader, distances);
+
+            if (distanceSymbol >= std::size(DistanceBases))
+                throw std::runtime_error("invalid distance code");
+
+            std::size_t const distance = DistanceBases[distanceSymbol] + reader.read(DistanceBits[distanceSymbol]);
+
+            if (distance > output.size())
+                throw std::runtime_error("distance too far back");
+
+            if (length > maxSize - output.size())
+                throw std::runtime_error("decompressed data too large");
+
+            // The source and the destination can overlap, the bytes are copied one by one
+            for (auto i = 0u; i < length; ++i)
+                output.push_back(output[output.size() - distance]);
+        }
+    }
+
+    void inflateFixedBlock(BitReader& reader, std::vector<unsigned char>& output, std::size_t maxSize)
+    {
+        static HuffmanCode const literals = []
+        {
+            std::array<unsigned char, 288u> lengths{};
+
+            for (auto i = 0u; i < lengths.size(); ++i)
+                lengths[i] = i < 144u ? 8u : i < 256u ? 9u : i < 280u ? 7u : 8u;
+
+            return makeHuffmanCode(lengths.data(), lengths.size());
+        }();
+        static HuffmanCode const distances = []
+        {
+            std::array<unsigned char, 30u> lengths{};
+
+            lengths.fill(5u);
+            return makeHuffmanCode(lengths.data(), lengths.size());
+        }();
+
+        inflateBlock(reader, literals, distances, output, maxSize);
+    }
+
+    void inflateDynamicBlock(BitReader& reader, std::vector<unsigned char>& output, std::size_t maxSize)
+    {
+        static constexpr std::uint8_t const CodeLengthOrder[] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+        auto const literalCount = reader.read(5u) + 257u;
+        auto const distanceCount = reader.read(5u) + 1u;
+        auto const codeLengthCount = reader.read(4u) + 4u;
+        std::array<unsigned char, std::size(CodeLengthOrder)> codeLengths{};
+        std::array<unsigned char, 320u> lengths{};
+
+        if (literalCount > 286u || distanceCount > 30u)
+            throw std::runtime_error("invalid count of codes");
+
+        for (auto i = 0u; i < codeLengthCount; ++i)
+            codeLengths[CodeLengthOrder[i]] = static_cast<unsigned char>(reader.read(3u));
+
+        auto const codeLengthCode = makeHuffmanCode(codeLengths.data(), codeLengths.size());
+
+        for (auto i = 0u; i < literalCount + distanceCount;)
+        {
+            auto const symbol = decodeSymbol(reader, codeLengthCode);
+
+            if (symbol < 16u)
+            {
+                lengths[i++] = static_cast<unsigned char>(symbol);
+                continue;
+            }
+
+            if (symbol == 16u && i == 0u)
+                throw std::runtime_error("no length to repeat");
+
+            auto const length = symbol == 16u ? lengths[i - 1u] : 0u;
+            auto const repeat = symbol == 16u ? 3u + reader.read(2u) : symbol == 17u ? 3u + reader.read(3u) : 11u + reader.read(7u);
+
+            if (i + repeat > literalCount + distanceCount)
+                throw std::runtime_error("too many code lengths");
+
+            for (auto j = 0u; j < repeat; ++j)
+                lengths[i++] = static_cast<unsigned char>(length);
+        }
+
+        if (lengths[256] == 0u)
+            throw std::runtime_error("no end of block code");
+
+        inflateBlock(reader, makeHuffmanCode(lengths.data(), literalCount),
+                     makeHuffmanCode(lengths.data() + literalCount, distanceCount), output, maxSize);
+    }
+
+    std::uint32_t readBigEndian(unsigned char const* bytes)
+    {
+        return (std::uint32_t{bytes[0]} << 24u) | (std::uint32_t{bytes[1]} << 16u) | (std::uint32_t{bytes[2]} << 8u) | bytes[3];
+    }
+
+    std::uint32_t computeAdler32(std::vector<unsigned char> const& bytes)
+    {
+        std::uint32_t a = 1u;
+        std::uint32_t b = 0u;
+
+        for (auto const byte : bytes)
+        {
+            a = (a + byte) % 65521u;
+            b = (b + a) % 65521u;
+        }
+
+        return (b << 16u) | a;
+    }
+
+    struct PngHeader
+    {
+        std::uint32_t width;
+        std::uint32_t height;
+        unsigned int bitDepth;
+        unsigned int colorType;
+        bool interlaced;
+
+        unsigned int channels() const
+        {
+            static constexpr unsigned int const Channels[] = {1u, 0u, 3u, 1u, 2u, 0u, 4u};
+
+            return Channels[colorType];
+        }
+
+        /// Count of bytes of a row of 'width' pixels, without the filter type.
+        std::size_t rowSize(std::uint32_t width) const
+        {
+            return (std::size_t{width} * channels() * bitDepth + 7u) / 8u;
+        }
+    };
+
+    PngHeader parsePngHeader(unsigned char const* data, std::uint32_t size)
+    {
+        if (size != 13u)
+            throw std::runtime_error("invalid IHDR chunk");
+
+        PngHeader const header{readBigEndian(data), readBigEndian(data + 4u), data[8], data[9], data[12] == 1u};
+        bool const validDepth = header.colorType == 0u ? (header.bitDepth & (header.bitDepth - 1u)) == 0u && header.bitDepth <= 16u
+                              : header.colorType == 3u ? (header.bitDepth & (header.bitDepth - 1u)) == 0u && header.bitDepth <= 8u
+                              : (header.colorType == 2u || header.colorType == 4u || header.colorType == 6u) && (header.bitDepth == 8u || header.bitDepth == 16u);
+
+        if (header.width == 0u || header.height == 0u || header.width > 0x7FFFFFFFu || header.height > 0x7FFFFFFFu)
+            throw std::runtime_error(format("invalid image size {}x{}", header.width, header.height));
+
+        if (header.colorType > 6u || header.bitDepth == 0u || !validDepth)
+            throw std::runtime_error(format("invalid bit depth {} for color type {}", header.bitDepth, header.colorType));
+
+        if (data[10] != 0u || data[11] != 0u || data[12] > 1u)
+            throw std::runtime_error("unknown compression, filter or interlace method");
+
+        if (std::uint64_t{header.width} * header.height > std::numeric_limits<std::uint32_t>::max() / 4u)
+            throw std::runtime_error(format("image too large {}x{}", header.width, header.height));
+
+        return header;
+    }
+
+    unsigned char paeth(unsigned char a, unsigned char b, unsigned char c)
+    {
+        int const p = a + b - c;
+        int const pa = std::abs(p - a);
+        int const pb = std::abs(p - b);
+        int const pc = std::abs(p - c);
+
+        return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+    }
+
+    /// Reverse the filter of 'row', 'previous' is the previous row already unfiltered or zeros.
+    void unfilterRow(unsigned int filter, unsigned char* row, unsigned char const* previous, std::size_t size, std::size_t pixelSize)
+    {
+        for (auto i = 0u; i < size; ++i)
+        {
+            unsigned char const left = i >= pixelSize ? row[i - pixelSize] : 0u;
+            unsigned char const up = previous[i];
+            unsigned char const upLeft = i >= pixelSize ? previous[i - pixelSize] : 0u;
+
+            switch (filter)
+            {
+            case 0u: break;
+            case 1u: row[i] = static_cast<unsigned char>(row[i] + left); break;
+            case 2u: row[i] = static_cast<unsigned char>(row[i] + up); break;
+            case 3u: row[i] = static_cast<unsigned char>(row[i] + (left + up) / 2); break;
+            case 4u: row[i] = static_cast<unsigned char>(row[i] + paeth(left, up, upLeft)); break;
+            default: throw std::runtime_error(format("invalid filter type {}", filter));
+            }
+        }
+    }
+
+    /// Returns the sample 'index' of 'row', on 'bitDepth' bits.
+    unsigned int readSample(unsigned char const* row, std::size_t index, unsigned int bitDepth)
+    {
+        if (bitDepth == 16u)
+            return (static_cast<unsigned int>(row[index * 2u]) << 8u) | row[index * 2u + 1u];
+
+        if (bitDepth == 8u)
+            return row[index];
+
+        auto const bit = index * bitDepth;
+
+        return (row[bit / 8u] >> (8u - bitDepth - bit % 8u)) & ((1u << bitDepth) - 1u);
+    }
+
+    /// Colors of the palette and transparency of the image.
+    struct PngColors
+    {
+        std::vector<std::array<unsigned char, 4u>> palette;
+        /// Gray level or RGB components of the transparent color, in the bit depth of the image
+        std::vector<unsigned int> transparentColor;
+    };
+
+    void convertPixel(PngHeader const& header, PngColors const& colors, unsigned char const* row, std::size_t x, unsigned char* pixel)
+    {
+        std::array<unsigned int, 4u> samples{};
+        auto const channels = header.channels();
+
+        for (auto c = 0u; c < channels; ++c)
+            samples[c] = readSample(row, x * channels + c, header.bitDepth);
+
+        if (header.colorType == 3u)
+        {
+            if (samples[0] >= colors.palette.size())
+                throw std::runtime_error(format("palette index {} out of range", samples[0]));
+
+            std::copy(colors.palette[samples[0]].begin(), colors.palette[samples[0]].end(), pixel);
+            return;
+        }
+
+        auto const to8Bits = [&header](unsigned int sample)
+        {
+            return static_cast<unsigned char>(header.bitDepth == 16u ? sample >> 8u : sample * 255u / ((1u << header.bitDepth) - 1u));
+        };
+        bool const gray = header.colorType == 0u || header.colorType == 4u;
+        bool const hasAlpha = header.colorType == 4u || header.colorType == 6u;
+        bool const transparent = !colors.transparentColor.empty()
+                              && std::equal(colors.transparentColor.begin(), colors.transparentColor.end(), samples.begin());
+
+        pixel[0] = to8Bits(samples[0]);
+        pixel[1] = gray ? pixel[0] : to8Bits(samples[1]);
+        pixel[2] = gray ? pixel[0] : to8Bits(samples[2]);
+        pixel[3] = hasAlpha ? to8Bits(samples[channels - 1u]) : transparent ? 0u : 255u;
+    }
+
+    void parseTransparency(PngHeader const& header, PngColors& colors, unsigned char const* data, std::uint32_t size)
+    {
+        if (header.colorType == 3u)
+        {
+            if (size > colors.palette.size())
+                throw std::runtime_error("invalid tRNS chunk");
+
+            for (auto i = 0u; i < size; ++i)
+                colors.palette[i][3] = data[i];
+        }
+        else if (header.colorType == 0u || header.colorType == 2u)
+        {
+            if (size != header.channels() * 2u)
+                throw std::runtime_error("invalid tRNS chunk");
+
+            for (auto i = 0u; i < size; i += 2u)
+                colors.transparentColor.push_back((static_cast<unsigned int>(data[i]) << 8u) | data[i + 1u]);
+        }
+        else
+        {
+            throw std::runtime_error("tRNS chunk not allowed with an alpha channel");
+        }
+    }
+}
+
+std::vector<unsigned char> inflate(unsigned char const* bytes, std::size_t size, std::size_t maxSize)
+{
+    if (size < 6u || (bytes[0] & 0x0Fu) != 8u || (bytes[0] >> 4u) > 7u || ((bytes[0] << 8u) | bytes[1]) % 31u != 0u)
+        throw std::runtime_error("invalid zlib header");
+
+    if (bytes[1] & 0x20u)
+        throw std::runtime_error("preset dictionaries are not supported");
+
+    BitReader reader{bytes + 2u, size - 6u};
+    std::vector<unsigned char> output;
+
+    for (bool last = false; !last;)
+    {
+        last = reader.read(1u) != 0u;
+
+        switch (reader.read(2u))
+        {
+        case 0u:
+        {
+            reader.alignToByte();
+
+            auto const length = reader.read(16u);
+
+            if (reader.read(16u) != (~length & 0xFFFFu))
+                throw std::runtime_error("invalid stored block");
+
+            if (length > maxSize - output.size())
+                throw std::runtime_error("decompressed data too large");
+
+            for (auto i = 0u; i < length; ++i)
+                output.push_back(static_cast<unsigned char>(reader.read(8u)));
+            break;
+        }
+        case 1u:
+            inflateFixedBlock(reader, output, maxSize);
+            break;
+        case 2u:
+            inflateDynamicBlock(reader, output, maxSize);
+            break;
+        default:
+            throw std::runtime_error("invalid block type");
+        }
+    }
+
+    if (readBigEndian(bytes + size - 4u) != computeAdler32(output))
+        throw std::runtime_error("invalid Adler-32 checksum");
+
+    return output;
+}
+
+DecodedImage decodePng(std::vector<char> const& file)
+{
+    auto const* const bytes = reinterpret_cast<unsigned char const*>(file.data());
+
+    if (file.size() < std::size(Signature) || !std::equal(std::begin(Signature), std::end(Signature), bytes))
+        throw std::runtime_error("not a PNG file");
+
+    std::optional<PngHeader> header;
+    PngColors colors;
+    std::vector<unsigned char> compressed;
+    bool ended = false;
+
+    for (auto position = std::size(Signature); !ended;)
+    {
+        if (file.size() - position < 12u)
+            throw std::runtime_error("unexpected end of the file");
+
+        auto const size = readBigEndian(bytes + position);
+        std::string_view const type{file.data() + position + 4u, 4u};
+        auto const* const data = bytes + position + 8u;
+
+        if (size > file.size() - position - 12u)
+            throw std::runtime_error(format("chunk '{}' too large", type));
+
+        if (readBigEndian(data + size) != computeCrc32(file.data() + position + 4u, size + 4u))
+            throw std::runtime_error(format("invalid checksum of the chunk '{}'", type));
+
+        if (!header.has_value() && type != "IHDR")
+            throw std::runtime_error("IHDR chunk expected first");
+
+        if (type == "IHDR")
+        {
+            if (header.has_value())
+                throw std::runtime_error("duplicate IHDR chunk");
+
+            header = parsePngHeader(data, size);
+        }
+        else if (type == "PLTE")
+        {
+            if (size % 3u != 0u || size == 0u || size > 256u * 3u)
+                throw std::runtime_error("invalid PLTE chunk");
+
+            for (auto i = 0u; i < size; i += 3u)
+                colors.palette.push_back({data[i], data[i + 1u], data[i + 2u], 255u});
+        }
+        else if (type == "tRNS")
+        {
+            parseTransparency(*header, colors, data, size);
+        }
+        else if (type == "IDAT")
+        {
+            compressed.insert(compressed.end(), data, data + size);
+        }
+        else if (type == "IEND")
+        {
+            ended = true;
+        }
+        else if (type[0] >= 'A' && type[0] <= 'Z')
+        {
+            throw std::runtime_error(format("unknown critical chunk '{}'", type));
+        }
+
+        position += 12u + size;
+    }
+
+    if (header->colorType == 3u && colors.palette.empty())
+        throw std::runtime_error("PLTE chunk expected");
+
+    // Adam7 passes, a single pass covers the whole image if it's not interlaced
+    struct Pass { std::uint32_t x, y, dx, dy; };
+    static constexpr Pass const Adam7[] = {{0, 0, 8, 8}, {4, 0, 8, 8}, {0, 4, 4, 8}, {2, 0, 4, 4}, {0, 2, 2, 4}, {1, 0, 2, 2}, {0, 1, 1, 2}};
+    static constexpr Pass const SinglePass[] = {{0, 0, 1, 1}};
+    auto const* const passes = header->interlaced ? std::begin(Adam7) : std::begin(SinglePass);
+    auto const* const passesEnd = header->interlaced ? std::end(Adam7) : std::end(SinglePass);
+    std::size_t expectedSize = 0u;
+
+    for (auto const* pass = passes; pass != passesEnd; ++pass)
+    {
+        auto const width = (header->width - std::min(pass->x, header->width) + pass->dx - 1u) / pass->dx;
+        auto const height = (header->height - std::min(pass->y, header->height) + pass->dy - 1u) / pass->dy;
+
+        if (width != 0u && height != 0u)
+            expectedSize += (header->rowSize(width) + 1u) * height;
+    }
+
+    auto filtered = inflate(compressed.data(), compressed.size(), expectedSize);
+
+    if (filtered.size() != expectedSize)
+        throw std::runtime_error("invalid size of the image data");
+
+    DecodedImage image{header->width, header->height, std::vector<unsigned char>(std::size_t{header->width} * header->height * 4u)};
+    auto const pixelSize = std::max(1u, header->channels() * header->bitDepth / 8u);
+    auto* row = filtered.data();
+
+    for (auto const* pass = passes; pass != passesEnd; ++pass)
+    {
+        auto const width = (header->width - std::min(pass->x, header->width) + pass->dx - 1u) / pass->dx;
+        auto const height = (header->height - std::min(pass->y, header->height) + pass->dy - 1u) / pass->dy;
+        auto const rowSize = header->rowSize(width);
+        std::vector<unsigned char> const zeros(rowSize, 0u);
+        unsigned char const* previous = zeros.data();
+
+        if (width == 0u || height == 0u)
+            continue;
+
+        for (auto y = 0u; y < height; ++y, previous = row + 1u, row += rowSize + 1u)
+        {
+            unfilterRow(row[0], row + 1u, previous, rowSize, pixelSize);
+
+            for (auto x = 0u; x < width; ++x)
+            {
+                auto const offset = (std::size_t{pass->y + y * pass->dy} * header->width + pass->x + x * pass->dx) * 4u;
+
+                convertPixel(*header, colors, row + 1u, x, image.pixels.data() + offset);
+            }
+        }
+    }
+
+    return image;
+}
+
+std::vector<char> encodeImage(DecodedImage const& image, PixelFormat pixelFormat, std::size_t rowAlignment)
+{
+    auto const pixelSize = static_cast<std::size_t>(pixelFormat);
+    auto const stride = (std::size_t{image.width} * pixelSize + rowAlignment - 1u) / rowAlignment * rowAlignment;
+
+    auto const pixelsOffset = getImagePixelsOffset(rowAlignment);
+
+    if (image.height != 0u && stride > (std::numeric_limits<std::uint32_t>::max() - pixelsOffset) / image.height)
+        throw std::runtime_error(format("image too large {}x{}", image.width, image.height));
+
+    std::vector<char> buffer(pixelsOffset + stride * image.height, '\0');
+    auto const writeInteger = [&buffer](std::size_t offset, std::uint64_t value, std::size_t size)
+    {
+        for (auto i = 0u; i < size; ++i)
+            buffer[offset + i] = static_cast<char>((value >> (8u * i)) & 0xFFu);
+    };
+
+    std::copy(ImageMagic.begin(), ImageMagic.end(), buffer.begin());
+    writeInteger(4u, image.width, 4u);
+    writeInteger(8u, image.height, 4u);
+    writeInteger(12u, pixelSize, 2u);
+    writeInteger(14u, rowAlignment, 2u);
+
+    for (auto y = 0u; y < image.height; ++y)
+    {
+        auto const* source = image.pixels.data() + std::size_t{y} * image.width * 4u;
+        auto* destination = buffer.data() + pixelsOffset + y * stride;
+
+        for (auto x = 0u; x < image.width; ++x, source += 4u)
+        {
+            for (auto c = 0u; c < pixelSize; ++c)
+                *destination++ = static_cast<char>(source[c]);
+        }
+    }
+
+    return buffer;
+}
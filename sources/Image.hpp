@@ -0,0 +1,52 @@
+#ifndef RESCOM_IMAGE_HPP
+#define RESCOM_IMAGE_HPP
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/// \brief Layout of the pixels embedded by the option 'png'
+/// The value is the count of bytes per pixel.
+enum class PixelFormat : std::uint8_t
+{
+    R8 = 1u,
+    Rgba8 = 4u
+};
+
+/// \brief Image decoded from a PNG file, 8 bits RGBA without padding
+struct DecodedImage
+{
+    std::uint32_t width = 0u;
+    std::uint32_t height = 0u;
+    std::vector<unsigned char> pixels;
+};
+
+/// Header of the embedded images, little endian:
+/// magic "RSCI", width (4 bytes), height (4 bytes), format (2 bytes), row alignment (2 bytes).
+/// The rows start at getImagePixelsOffset(), each row is padded to a multiple of the alignment.
+static constexpr std::string_view const ImageMagic = "RSCI";
+static constexpr std::size_t const ImageHeaderSize = 16u;
+static constexpr std::size_t const MaxRowAlignment = 256u;
+
+/// Returns the offset of the first row: the header is padded to the row alignment, so the rows are aligned
+/// in memory when the resource itself is aligned on max(ImageHeaderSize, rowAlignment).
+constexpr std::size_t getImagePixelsOffset(std::size_t rowAlignment)
+{
+    return rowAlignment > ImageHeaderSize ? rowAlignment : ImageHeaderSize;
+}
+
+/// Decompress a zlib stream (RFC 1950 and 1951) producing at most 'maxSize' bytes.
+/// Throws std::runtime_error if the stream is invalid or too large.
+std::vector<unsigned char> inflate(unsigned char const* bytes, std::size_t size, std::size_t maxSize);
+
+/// Decode a PNG file. All the color types and bit depths are supported, as well as interlacing and transparency (tRNS).
+/// The samples of 16 bits are truncated to 8 bits.
+/// Throws std::runtime_error if the file is invalid.
+DecodedImage decodePng(std::vector<char> const& file);
+
+/// Returns the header followed by the rows of 'image' converted to 'pixelFormat'.
+/// R8 keeps the red channel, which is the gray level of the grayscale images.
+/// Throws std::runtime_error if the image is too large to be embedded.
+std::vector<char> encodeImage(DecodedImage const& image, PixelFormat pixelFormat, std::size_t rowAlignment);
+
+#endif //RESCOM_IMAGE_HPP
@@ -0,0 +1,451 @@
+#include "Json.hpp"
+#include "StringHelpers.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    static constexpr unsigned int const MaximumDepth = 512u;
+
+    class JsonCompiler
+    {
+        std::string_view const _text;
+        std::size_t _position = 0u;
+        unsigned int _depth = 0u;
+        std::vector<char> _tape;
+    public:
+        explicit JsonCompiler(std::string_view text)
+        : _text(text)
+        {
+        }
+
+        std::vector<char> compile()
+        {
+            // Placeholder for the offset of the root value
+            writeInteger<std::uint32_t>(0u);
+
+            skipSpaces();
+
+            auto const rootOffset = parseValue();
+
+            skipSpaces();
+
+            if (_position != _text.size())
+                error("unexpected character after the document");
+
+            patchInteger<std::uint32_t>(0u, rootOffset);
+
+            return std::move(_tape);
+        }
+    private:
+        [[noreturn]] void error(std::string const& message) const
+        {
+            auto const parsed = _text.substr(0u, std::min(_position, _text.size()));
+            auto const line = std::count(parsed.begin(), parsed.end(), '\n') + 1;
+            auto const lineStart = parsed.rfind('\n');
+            auto const column = lineStart == std::string_view::npos ? parsed.size() + 1u : parsed.size() - lineStart;
+
+            throw std::runtime_error(format("line {}, column {}: {}", line, column, message));
+        }
+
+        bool atEnd() const
+        {
+            return _position >= _text.size();
+        }
+
+        char peek() const
+        {
+            return atEnd() ? '\0' : _text[_position];
+        }
+
+        void expect(char expected)
+        {
+            if (peek() != expected)
+                error(format("'{}' expected", std::string(1u, expected)));
+
+            ++_position;
+        }
+
+        void skipSpaces()
+        {
+            while (!atEnd() && (peek() == ' ' || peek() == '\t' || peek() == '\n' || peek() == '\r'))
+                ++_position;
+        }
+
+        template <typename T>
+        void writeInteger(T value)
+        {
+            for (auto i = 0u; i < sizeof(T); ++i)
+                _tape.push_back(static_cast<char>((value >> (i * 8u)) & 0xFFu));
+        }
+
+        template <typename T>
+        void patchInteger(std::size_t offset, T value)
+        {
+            for (auto i = 0u; i < sizeof(T); ++i)
+                _tape[offset + i] = static_cast<char>((value >> (i * 8u)) & 0xFFu);
+        }
+
+        std::uint32_t currentOffset() const
+        {
+            if (_tape.size() > UINT32_MAX)
+                throw std::runtime_error("JSON document too big");
+
+            return static_cast<std::uint32_t>(_tape.size());
+        }
+
+        std::uint32_t parseValue()
+        {
+            switch (peek())
+            {
+                case '{': return parseObject();
+                case '[': return parseArray();
+                case '"': return writeString(parseString());
+                case 't': return parseLiteral("true", JsonTape::True);
+                case 'f': return parseLiteral("false", JsonTape::False);
+                case 'n': return parseLiteral("null", JsonTape::Null);
+                default:
+                    if (peek() == '-' || (peek() >= '0' && peek() <= '9'))
+                        return parseNumber();
+                    error("value expected");
+            }
+        }
+
+        std::uint32_t parseLiteral(std::string_view literal, char tag)
+        {
+            if (_text.substr(_position, literal.size()) != literal)
+                error("value expected");
+
+            _position += literal.size();
+
+            auto const offset = currentOffset();
+
+            _tape.push_back(tag);
+
+            return offset;
+        }
+
+        std::uint32_t parseNumber()
+        {
+            auto const start = _position;
+            bool isInteger = true;
+            auto const skipDigits = [this]()
+            {
+                auto const digitsStart = _position;
+
+                while (peek() >= '0' && peek() <= '9')
+                    ++_position;
+
+                if (_position == digitsStart)
+                    error("digit expected");
+            };
+
+            if (peek() == '-')
+                ++_position;
+
+            if (peek() == '0')
+                ++_position;
+            else
+                skipDigits();
+
+            if (peek() == '.')
+            {
+                isInteger = false;
+                ++_position;
+                skipDigits();
+            }
+
+            if (peek() == 'e' || peek() == 'E')
+            {
+                isInteger = false;
+                ++_position;
+
+                if (peek() == '+' || peek() == '-')
+                    ++_position;
+
+                skipDigits();
+            }
+
+            auto const number = _text.substr(start, _position - start);
+            auto const offset = currentOffset();
+
+            if (isInteger)
+            {
+                std::int64_t value = 0;
+                auto const [end, errorCode] = std::from_chars(number.data(), number.data() + number.size(), value);
+
+                if (errorCode == std::errc{} && end == number.data() + number.size())
+                {
+                    _tape.push_back(JsonTape::Integer);
+                    writeInteger(static_cast<std::uint64_t>(value));
+
+                    return offset;
+                }
+            }
+
+            std::string const nullTerminated{number};
+            double const value = std::strtod(nullTerminated.c_str(), nullptr);
+
+            if (!std::isfinite(value))
+                error(format("number out of range '{}'", number));
+
+            std::uint64_t bits = 0u;
+
+            std::memcpy(&bits, &value, sizeof(bits));
+            _tape.push_back(JsonTape::Number);
+            writeInteger(bits);
+
+            return offset;
+        }
+
+        unsigned int parseHexadecimal()
+        {
+            unsigned int value = 0u;
+
+            for (auto i = 0u; i < 4u; ++i)
+            {
+                auto const c = peek();
+
+                value <<= 4u;
+
+                if (c >= '0' && c <= '9')
+                    value |= static_cast<unsigned int>(c - '0');
+                else if (c >= 'a' && c <= 'f')
+                    value |= static_cast<unsigned int>(c - 'a' + 10);
+                else if (c >= 'A' && c <= 'F')
+                    value |= static_cast<unsigned int>(c - 'A' + 10);
+                else
+                    error("hexadecimal digit expected");
+
+                ++_position;
+            }
+
+            return value;
+        }
+
+        static void appendUtf8(std::string& result, unsigned int codePoint)
+        {
+            if (codePoint < 0x80u)
+            {
+                result.push_back(static_cast<char>(codePoint));
+            }
+            else if (codePoint < 0x800u)
+            {
+                result.push_back(static_cast<char>(0xC0u | (codePoint >> 6u)));
+                result.push_back(static_cast<char>(0x80u | (codePoint & 0x3Fu)));
+            }
+            else if (codePoint < 0x10000u)
+            {
+                result.push_back(static_cast<char>(0xE0u | (codePoint >> 12u)));
+                result.push_back(static_cast<char>(0x80u | ((codePoint >> 6u) & 0x3Fu)));
+                result.push_back(static_cast<char>(0x80u | (codePoint & 0x3Fu)));
+            }
+            else
+            {
+                result.push_back(static_cast<char>(0xF0u | (codePoint >> 18u)));
+                result.push_back(static_cast<char>(0x80u | ((codePoint >> 12u) & 0x3Fu)));
+                result.push_back(static_cast<char>(0x80u | ((codePoint >> 6u) & 0x3Fu)));
+                result.push_back(static_cast<char>(0x80u | (codePoint & 0x3Fu)));
+            }
+        }
+
+        std::string parseString()
+        {
+            std::string result;
+
+            expect('"');
+
+            while (peek() != '"')
+            {
+                if (atEnd())
+                    error("unterminated string");
+
+                auto const c = _text[_position++];
+
+                if (static_cast<unsigned char>(c) < 0x20u)
+                {
+                    --_position;
+                    error("control character in string");
+                }
+
+                if (c != '\\')
+                {
+                    result.push_back(c);
+                    continue;
+                }
+
+                if (atEnd())
+                    error("unterminated string");
+
+                switch (auto const escaped = _text[_position++]; escaped)
+                {
+                    case '"': result.push_back('"'); break;
+                    case '\\': result.push_back('\\'); break;
+                    case '/': result.push_back('/'); break;
+                    case 'b': result.push_back('\b'); break;
+                    case 'f': result.push_back('\f'); break;
+                    case 'n': result.push_back('\n'); break;
+                    case 'r': result.push_back('\r'); break;
+                    case 't': result.push_back('\t'); break;
+                    case 'u':
+                    {
+                        auto codePoint = parseHexadecimal();
+
+                        if (codePoint >= 0xD800u && codePoint < 0xDC00u)
+                        {
+                            expect('\\');
+                            expect('u');
+
+                            auto const lowSurrogate = parseHexadecimal();
+
+                            if (lowSurrogate < 0xDC00u || lowSurrogate >= 0xE000u)
+                                error("invalid UTF-16 surrogate pair");
+
+                            codePoint = 0x10000u + ((codePoint - 0xD800u) << 10u) + (lowSurrogate - 0xDC00u);
+                        }
+                        else if (codePoint >= 0xDC00u && codePoint < 0xE000u)
+                        {
+                            error("invalid UTF-16 surrogate pair");
+                        }
+
+                        appendUtf8(result, codePoint);
+                        break;
+                    }
+                    default:
+                        --_position;
+                        error("invalid escape sequence");
+                }
+            }
+
+            expect('"');
+
+            return result;
+        }
+
+        std::uint32_t writeString(std::string const& text)
+        {
+            auto const offset = currentOffset();
+
+            _tape.push_back(JsonTape::String);
+            writeInteger(static_cast<std::uint32_t>(text.size()));
+            _tape.insert(_tape.end(), text.begin(), text.end());
+            _tape.push_back('\0');
+
+            return offset;
+        }
+
+        void enter()
+        {
+            if (++_depth > MaximumDepth)
+                error("maximum depth exceeded");
+        }
+
+        /// Children are written before the array itself, so the size of the array is known when it's written.
+        std::uint32_t parseArray()
+        {
+            std::vector<std::uint32_t> elements;
+
+            enter();
+            expect('[');
+            skipSpaces();
+
+            while (peek() != ']')
+            {
+                if (!elements.empty())
+                {
+                    expect(',');
+                    skipSpaces();
+                }
+
+                elements.push_back(parseValue());
+                skipSpaces();
+            }
+
+            expect(']');
+            --_depth;
+
+            auto const offset = currentOffset();
+
+            _tape.push_back(JsonTape::Array);
+            writeInteger(static_cast<std::uint32_t>(elements.size()));
+
+            for (auto const element : elements)
+                writeInteger(element);
+
+            return offset;
+        }
+
+        struct Member
+        {
+            std::string key;
+            std::uint32_t keyOffset;
+            std::uint32_t valueOffset;
+        };
+
+        /// Members are sorted by key, allowing to find a member using a binary search.
+        std::uint32_t parseObject()
+        {
+            std::vector<Member> members;
+
+            enter();
+            expect('{');
+            skipSpaces();
+
+            while (peek() != '}')
+            {
+                if (!members.empty())
+                {
+                    expect(',');
+                    skipSpaces();
+                }
+
+                auto key = parseString();
+                auto const keyOffset = writeString(key);
+
+                skipSpaces();
+                expect(':');
+                skipSpaces();
+
+                auto const valueOffset = parseValue();
+
+                members.push_back(Member{std::move(key), keyOffset, valueOffset});
+                skipSpaces();
+            }
+
+            expect('}');
+            --_depth;
+
+            std::sort(members.begin(), members.end(), [](Member const& left, Member const& right) { return left.key < right.key; });
+
+            auto const duplicate = std::adjacent_find(members.begin(), members.end(), [](Member const& left, Member const& right) { return left.key == right.key; });
+
+            if (duplicate != members.end())
+                error(format("duplicate key '{}'", duplicate->key));
+
+            auto const offset = currentOffset();
+
+            _tape.push_back(JsonTape::Object);
+            writeInteger(static_cast<std::uint32_t>(members.size()));
+
+            for (auto const& member : members)
+            {
+                writeInteger(member.keyOffset);
+                writeInteger(member.valueOffset);
+            }
+
+            return offset;
+        }
+    };
+}
+
+std::vector<char> compileJson(std::vector<char> const& text)
+{
+    return JsonCompiler{std::string_view{text.data(), text.size()}}.compile();
+}
@@ -0,0 +1,32 @@
+#ifndef RESCOM_JSON_HPP
+#define RESCOM_JSON_HPP
+#include <cstdint>
+#include <vector>
+
+/// \brief Binary representation of a JSON document
+/// The document starts with the offset of the root value. Each value starts with a tag, integers are
+/// stored in little endian.
+///  - Null, True, False: no payload
+///  - Integer: int64
+///  - Number: IEEE 754 binary64
+///  - String: uint32 size, the bytes, a null character
+///  - Array: uint32 count, count uint32 offsets of the values
+///  - Object: uint32 count, count pairs of uint32 offsets (key, value) sorted by key. Keys are strings.
+/// Offsets are relative to the beginning of the document.
+namespace JsonTape
+{
+    static constexpr char const Null = 'n';
+    static constexpr char const True = 't';
+    static constexpr char const False = 'f';
+    static constexpr char const Integer = 'i';
+    static constexpr char const Number = 'd';
+    static constexpr char const String = 's';
+    static constexpr char const Array = 'a';
+    static constexpr char const Object = 'o';
+}
+
+/// Parse a JSON text and returns its binary representation.
+/// Throws std::runtime_error if the text is not a valid JSON document.
+std::vector<char> compileJson(std::vector<char> const& text);
+
+#endif //RESCOM_JSON_HPP
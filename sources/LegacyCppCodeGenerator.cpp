@@ -1,11 +1,22 @@
 #include "LegacyCppCodeGenerator.hpp"
 #include "Configuration.hpp"
 #include "StringHelpers.hpp"
+#include "LineIndex.hpp"
+#include "CsvTable.hpp"
+#include "Json.hpp"
+#include "Dictionary.hpp"
+#include "Variants.hpp"
+#include "Compression.hpp"
+#include "Image.hpp"
+#include "ResourceSet.hpp"
 
+#include <algorithm>
+#include <cctype>
 #include <filesystem>
 #include <fstream>
 #include <iterator>
 #include <iostream>
+#include <optional>
 #include <stdexcept>
 #include <sstream>
 #include <streambuf>
@@ -14,20 +25,53 @@
 namespace
 {
     static constexpr char const* NamespaceForResourceData = "rescom";
+    static constexpr unsigned int const TableAlignment = 64u;
+    static constexpr ColumnType const AllColumnTypes[] = {
+        ColumnType::Int8, ColumnType::Int16, ColumnType::Int32, ColumnType::Int64,
+        ColumnType::UInt8, ColumnType::UInt16, ColumnType::UInt32, ColumnType::UInt64,
+        ColumnType::Float, ColumnType::Double
+    };
 
-    void loadFile(std::filesystem::path const& filePath, std::vector<char>& buffer)
+    /// Call 'compile' with the content of the input.
+    /// If the compilation fails the error message is prefixed by the path of the input.
+    template <typename Compile>
+    auto compileInput(Input const& input, std::vector<char> const& buffer, Compile&& compile)
     {
-        std::ifstream file{filePath, std::ios::binary};
-
-        if (file.is_open())
+        try
         {
-            buffer.assign(std::istreambuf_iterator<char>(file), {});
+            return compile(buffer);
         }
-        else
+        catch (std::runtime_error const& error)
         {
-            throw std::runtime_error(format("unable to read '{}'", filePath.generic_string()));
+            throw std::runtime_error(format("{}: {}", input.filePath.generic_string(), error.what()));
         }
     }
+
+    /// Returns the name of the enumerator of the generated enumeration ColumnType (Int8, Float...).
+    std::string toTypeName(ColumnType type)
+    {
+        auto name = toString(type);
+
+        name.front() = static_cast<char>(std::toupper(static_cast<unsigned char>(name.front())));
+        if (name.front() == 'U')
+            name[1] = 'I';
+
+        return name;
+    }
+
+    /// Returns the row alignment of an image, decoded by the transform 'png' whose identity is "png=<format>,<alignment>".
+    std::optional<std::size_t> getImageRowAlignment(Input const& input)
+    {
+        if (input.transforms.empty())
+            return std::nullopt;
+
+        auto const identity = input.transforms.back()->identity();
+
+        if (identity.substr(0u, 4u) != "png=" || identity.find(',') == std::string::npos)
+            return std::nullopt;
+
+        return static_cast<std::size_t>(std::stoul(identity.substr(identity.find(',') + 1u)));
+    }
 }
 
 static std::string const HeaderProtectionMacroPrefix = "RESCOM_GENERATED_FILE_";
@@ -59,35 +103,394 @@ void LegacyCppCodeGenerator::generate(std::ostream& output)
     writeFileHeader(output);
     writeResources(output);
     writeAccessFunction(output);
+    if (hasVariants())
+        writeVariantAccessFunctions(output);
+    if (hasLineIndex())
+        writeLineAccessFunctions(output);
+    if (hasTable())
+        writeTableAccessFunctions(output);
+    if (hasJson())
+        writeJsonAccessFunctions(output);
+    if (hasDictionary(DictionaryType::Map) || hasDictionary(DictionaryType::Set))
+        writeDictionaryAccessFunctions(output);
+    if (hasImages())
+        writeImageAccessFunctions(output);
+    if (hasCompression())
+        writeReader(output);
+    if (_configuration.runtimeCacheBudget.has_value())
+        writeCacheFunctions(output);
+    if (_configuration.externalArchive)
+        writeArchiveFunctions(output);
     writeFileFooter(output);
 }
 
 void LegacyCppCodeGenerator::writeFileHeader(std::ostream& output) const
 {
-    static std::string const Includes[] = {
+    std::vector<std::string> includes = {
+        "<cstddef>", // for std::ptrdiff_t
         "<iterator>", // for std::iterator_traits
         "<string_view>",
         "<cstring>" // for std::strcmp
     };
+
+    if (hasTable() || hasJson() || hasDictionary(DictionaryType::Map) || hasDictionary(DictionaryType::Set))
+        includes.emplace_back("<cstdint>");
+
+    if (hasCompression())
+        includes.emplace_back("<vector>");
+
+    if (_configuration.runtimeCacheBudget.has_value())
+    {
+        for (auto const* include : {"<atomic>", "<cstdint>", "<memory>", "<mutex>", "<thread>", "<type_traits>", "<utility>", "<vector>"})
+        {
+            if (std::find(includes.begin(), includes.end(), include) == includes.end())
+                includes.emplace_back(include);
+        }
+    }
+
+    if (_configuration.externalArchive)
+    {
+        for (auto const* include : {"<algorithm>", "<atomic>", "<cstdint>", "<memory>", "<mutex>", "<vector>"})
+        {
+            if (std::find(includes.begin(), includes.end(), include) == includes.end())
+                includes.emplace_back(include);
+        }
+    }
+
+    if (hasOverlay())
+    {
+        for (auto const* include : {"<algorithm>", "<cstdint>", "<functional>", "<memory>", "<type_traits>", "<vector>"})
+        {
+            if (std::find(includes.begin(), includes.end(), include) == includes.end())
+                includes.emplace_back(include);
+        }
+    }
+
     auto resourceFileStem = toLower(_configuration.configurationFilePath.stem().generic_string());
 
     output << "// Generated by Rescom\n";
     output << format("#ifndef {}\n#define {}\n", _headerProtectionMacroName, _headerProtectionMacroName);
 
-    for (auto const& include : Includes)
+    for (auto const& include : includes)
         output << format("#include {}\n", include);
+
+    // Archives are mapped in memory on POSIX systems and read in memory otherwise
+    if (_configuration.externalArchive || hasOverlay())
+    {
+        output << "#if defined(_WIN32)\n"
+               << "#include <fstream>\n"
+               << "#include <vector>\n"
+               << "#else\n"
+               << "#include <fcntl.h>\n"
+               << "#include <sys/mman.h>\n"
+               << "#include <sys/stat.h>\n"
+               << "#include <unistd.h>\n"
+               << "#endif\n";
+    }
+
+    // std::is_constant_evaluated is C++20, GCC and Clang provide its builtin in C++17 too.
+    // Without both, RESCOM_IS_CONSTANT_EVALUATED is not defined and the code using it isn't constexpr.
+    output << "#if !defined(RESCOM_IS_CONSTANT_EVALUATED)\n"
+           << "#if defined(__cpp_lib_is_constant_evaluated)\n"
+           << "#define RESCOM_IS_CONSTANT_EVALUATED() std::is_constant_evaluated()\n"
+           << "#elif defined(__GNUC__) || defined(__clang__)\n"
+           << "#define RESCOM_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()\n"
+           << "#endif\n"
+           << "#endif\n";
+
+    // Static tracepoints are only compiled when RESCOM_USDT is defined, see writeProbes.
+    // RESCOM_PROBE is a single statement, so it can't capture an else following it.
+    output << "#if defined(RESCOM_USDT) && defined(__linux__) && defined(RESCOM_IS_CONSTANT_EVALUATED) && __has_include(<sys/sdt.h>)\n"
+           << "#include <sys/sdt.h>\n"
+           << "#define RESCOM_USDT_ENABLED 1\n"
+           << "#endif\n"
+           << "#if !defined(RESCOM_PROBE)\n"
+           << "#if defined(RESCOM_USDT_ENABLED)\n"
+           << "#define RESCOM_PROBE(probe) do { if (!RESCOM_IS_CONSTANT_EVALUATED()) details::probe; } while (false)\n"
+           << "#else\n"
+           << "#define RESCOM_PROBE(probe) do { } while (false)\n"
+           << "#endif\n"
+           << "#endif\n";
     output << "\n";
 
     output << tab(0) << "namespace " << NamespaceForResourceData << "::" << resourceFileStem << "\n{\n";
-    output << tab(1) << "struct Resource\n"
+    if (_configuration.inlineThreshold == 0u)
+    {
+        output << tab(1) << "struct Resource\n"
+               << tab(1) << "{\n"
+               << tab(2) << "char const* const key;\n"
+               << tab(2) << "char const* const bytes;\n"
+               << tab(2) << "unsigned int const size;\n"
+               << "\n"
+               << tab(2) << "constexpr Resource(char const* key, unsigned int size, char const* bytes)\n"
+               << tab(2) << ": key(key), bytes(bytes), size(size) {}\n"
+               << tab(1) << "};\n\n";
+    }
+    else
+    {
+        // The bytes of the tiny resources are stored in the slot, 'bytes' points to 'inlineBytes'
+        output << tab(1) << "static constexpr unsigned int const InlineCapacity = " << _configuration.inlineThreshold << "u;\n\n"
+               << tab(1) << "struct Resource\n"
+               << tab(1) << "{\n"
+               << tab(2) << "char const* const key;\n"
+               << tab(2) << "char const* const bytes;\n"
+               << tab(2) << "unsigned int const size;\n"
+               << tab(2) << "char inlineBytes[InlineCapacity];\n"
+               << "\n"
+               << tab(2) << "constexpr Resource(char const* key, unsigned int size, char const* bytes)\n"
+               << tab(2) << ": key(key), bytes(bytes), size(size), inlineBytes{} {}\n"
+               << "\n"
+               << tab(2) << "template <unsigned int N>\n"
+               << tab(2) << "constexpr Resource(char const* key, unsigned int size, char const* bytes, char const (&text)[N])\n"
+               << tab(2) << ": key(key), bytes(bytes), size(size), inlineBytes{}\n"
+               << tab(2) << "{\n"
+               << tab(3) << "static_assert(N <= InlineCapacity + 1u, \"resource too large to be stored inline\");\n"
+               << "\n"
+               << tab(3) << "for (auto i = 0u; i < size; ++i)\n"
+               << tab(4) << "inlineBytes[i] = text[i];\n"
+               << tab(2) << "}\n"
+               << "\n"
+               << tab(2) << "constexpr bool isInline() const { return bytes == inlineBytes; }\n"
+               << tab(1) << "};\n\n";
+    }
+
+    if (hasLineIndex())
+    {
+        // Offset of the line n is checkpoints[n / LineCheckpointInterval] + deltas[n].
+        // Only one of the deltas arrays is not null, depending on the maximum delta of the resource.
+        output << tab(1) << "static constexpr unsigned int const LineCheckpointInterval = " << LineIndex::CheckpointInterval << "u;\n\n"
+               << tab(1) << "struct LineIndex\n"
+               << tab(1) << "{\n"
+               << tab(2) << "unsigned int const count;\n"
+               << tab(2) << "unsigned int const* const checkpoints;\n"
+               << tab(2) << "unsigned char const* const deltas8;\n"
+               << tab(2) << "unsigned short const* const deltas16;\n"
+               << tab(2) << "unsigned int const* const deltas32;\n"
+               << "\n"
+               << tab(2) << "constexpr unsigned int offset(unsigned int line) const\n"
+               << tab(2) << "{\n"
+               << tab(3) << "unsigned int const delta = deltas8 != nullptr ? deltas8[line] : deltas16 != nullptr ? deltas16[line] : deltas32[line];\n"
+               << "\n"
+               << tab(3) << "return checkpoints[line / LineCheckpointInterval] + delta;\n"
+               << tab(2) << "}\n"
+               << tab(1) << "};\n\n";
+    }
+
+    if (hasTable())
+        writeTableTypes(output);
+
+    if (hasDictionary(DictionaryType::Map) || hasDictionary(DictionaryType::Set))
+        writeDictionaryTypes(output);
+
+    if (hasCompression())
+        writeCompressionTypes(output);
+
+    writeProbes(output);
+}
+
+/// Write the functions firing the static tracepoints of the provider 'rescom'.
+/// The probes are not constexpr, RESCOM_PROBE skips them in constant evaluation so the lookups stay constexpr.
+/// Latencies are measured by the tracer between the '__start' and '__done' probes, no clock is read here.
+void LegacyCppCodeGenerator::writeProbes(std::ostream& output) const
+{
+    output << "#if defined(RESCOM_USDT_ENABLED)\n"
+           << tab(1) << "namespace details {\n"
+           << tab(2) << "inline void probeLookupStart(char const* key) { DTRACE_PROBE1(rescom, lookup__start, key); }\n"
+           << tab(2) << "inline void probeLookupHit(char const* key, std::size_t size) { DTRACE_PROBE2(rescom, lookup__hit, key, size); }\n"
+           << tab(2) << "inline void probeLookupMiss(char const* key) { DTRACE_PROBE1(rescom, lookup__miss, key); }\n";
+
+    if (hasCompression())
+    {
+        output << tab(2) << "inline void probeDecompressStart(char const* key, unsigned int frame) { DTRACE_PROBE2(rescom, decompress__start, key, frame); }\n"
+               << tab(2) << "inline void probeDecompressDone(char const* key, unsigned int frame, std::size_t size) { DTRACE_PROBE3(rescom, decompress__done, key, frame, size); }\n";
+    }
+
+    if (_configuration.runtimeCacheBudget.has_value())
+    {
+        output << tab(2) << "inline void probeCacheHit(char const* key) { DTRACE_PROBE1(rescom, cache__hit, key); }\n"
+               << tab(2) << "inline void probeDecodeStart(char const* key, std::size_t size) { DTRACE_PROBE2(rescom, decode__start, key, size); }\n"
+               << tab(2) << "inline void probeDecodeDone(char const* key, std::size_t cost) { DTRACE_PROBE2(rescom, decode__done, key, cost); }\n";
+    }
+
+    if (_configuration.externalArchive)
+    {
+        output << tab(2) << "inline void probeReloadStart(char const* path) { DTRACE_PROBE1(rescom, reload__start, path); }\n"
+               << tab(2) << "inline void probeReloadDone(char const* path, std::size_t size, int loaded) { DTRACE_PROBE3(rescom, reload__done, path, size, loaded); }\n";
+    }
+
+    output << tab(1) << "} // namespace details\n"
+           << "#endif\n\n";
+}
+
+/// Write the types used to store compressed resources and the function decoding a frame.
+void LegacyCppCodeGenerator::writeCompressionTypes(std::ostream& output) const
+{
+    output << tab(1) << "namespace details {\n";
+
+    // The offsets of the frames are the seek table: the frame N is stored between offsets[N] and offsets[N + 1]
+    output << tab(2) << "struct CompressedResource\n"
+           << tab(2) << "{\n"
+           << tab(3) << "unsigned int const size;\n"
+           << tab(3) << "unsigned int const frameSize;\n"
+           << tab(3) << "unsigned int const frameCount;\n"
+           << tab(3) << "unsigned int const* const offsets;\n"
+           << tab(2) << "};\n\n";
+
+    // Print the decoder of the LZ4 sequences, see Compression.hpp
+    output << tab(2) << "inline unsigned char const* readLength(unsigned char const* source, std::size_t& length)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "for (unsigned char byte = 255u; byte == 255u; length += byte)\n"
+           << tab(4) << "byte = *source++;\n"
+           << "\n"
+           << tab(3) << "return source;\n"
+           << tab(2) << "}\n\n"
+           << tab(2) << "inline void decodeFrame(unsigned char const* source, unsigned char const* sourceEnd, char* destination)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "while (source < sourceEnd)\n"
+           << tab(3) << "{\n"
+           << tab(4) << "unsigned int const token = *source++;\n"
+           << tab(4) << "std::size_t literals = token >> 4u;\n"
+           << "\n"
+           << tab(4) << "if (literals == 15u)\n"
+           << tab(5) << "source = readLength(source, literals);\n"
+           << "\n"
+           << tab(4) << "std::memcpy(destination, source, literals);\n"
+           << tab(4) << "destination += literals;\n"
+           << tab(4) << "source += literals;\n"
+           << "\n"
+           << tab(4) << "if (source == sourceEnd)\n"
+           << tab(5) << "return;\n"
+           << "\n"
+           << tab(4) << "std::size_t const offset = source[0] | (source[1] << 8u);\n"
+           << tab(4) << "std::size_t length = (token & 15u) + 4u;\n"
+           << "\n"
+           << tab(4) << "source += 2u;\n"
+           << tab(4) << "if ((token & 15u) == 15u)\n"
+           << tab(5) << "source = readLength(source, length);\n"
+           << "\n"
+           << tab(4) << "// The match can overlap the bytes it produces\n"
+           << tab(4) << "for (char const* match = destination - offset; length > 0u; --length)\n"
+           << tab(5) << "*destination++ = *match++;\n"
+           << tab(3) << "}\n"
+           << tab(2) << "}\n";
+
+    output << tab(1) << "} // namespace details\n\n";
+}
+
+/// Write the types used to store CSV tables.
+/// Each column is stored in an array aligned to allow SIMD loads.
+void LegacyCppCodeGenerator::writeTableTypes(std::ostream& output) const
+{
+    output << tab(1) << "static constexpr std::size_t const TableAlignment = " << TableAlignment << "u;\n\n";
+
+    output << tab(1) << "enum class ColumnType\n"
+           << tab(1) << "{\n";
+    for (auto const type : AllColumnTypes)
+        output << tab(2) << toTypeName(type) << ",\n";
+    output << tab(1) << "};\n\n";
+
+    // Print class rescom::Column
+    output << tab(1) << "template <typename T>\n"
+           << tab(1) << "struct Column\n"
            << tab(1) << "{\n"
-           << tab(2) << "char const* const key;\n"
-           << tab(2) << "char const* const bytes;\n"
+           << tab(2) << "T const* const data;\n"
            << tab(2) << "unsigned int const size;\n"
            << "\n"
-           << tab(2) << "constexpr Resource(char const* key, unsigned int size, char const* bytes)\n"
-           << tab(2) << ": key(key), bytes(bytes), size(size) {}\n"
+           << tab(2) << "constexpr bool empty() const { return size == 0u; }\n"
+           << tab(2) << "constexpr T const& operator[](unsigned int row) const { return data[row]; }\n"
+           << tab(2) << "constexpr T const* begin() const { return data; }\n"
+           << tab(2) << "constexpr T const* end() const { return data + size; }\n"
            << tab(1) << "};\n\n";
+
+    output << tab(1) << "namespace details {\n";
+
+    // Only the member matching the type of the column is active.
+    output << tab(2) << "union ColumnData\n"
+           << tab(2) << "{\n";
+    for (auto const type : AllColumnTypes)
+        output << tab(3) << toCppType(type) << " const* as" << toTypeName(type) << ";\n";
+    output << "\n";
+    for (auto const type : AllColumnTypes)
+        output << tab(3) << "constexpr ColumnData(" << toCppType(type) << " const* data) : as" << toTypeName(type) << "(data) {}\n";
+    output << tab(2) << "};\n\n";
+
+    output << tab(2) << "struct TableColumn\n"
+           << tab(2) << "{\n"
+           << tab(3) << "char const* const name;\n"
+           << tab(3) << "ColumnType const type;\n"
+           << tab(3) << "unsigned int const size;\n"
+           << tab(3) << "ColumnData const data;\n"
+           << tab(2) << "};\n\n";
+
+    output << tab(2) << "struct Table\n"
+           << tab(2) << "{\n"
+           << tab(3) << "unsigned int const columnCount;\n"
+           << tab(3) << "TableColumn const* const columns;\n"
+           << tab(2) << "};\n\n";
+
+    output << tab(2) << "template <typename T>\n"
+           << tab(2) << "struct ColumnTraits;\n\n";
+    for (auto const type : AllColumnTypes)
+    {
+        output << tab(2) << "template <>\n"
+               << tab(2) << "struct ColumnTraits<" << toCppType(type) << ">\n"
+               << tab(2) << "{\n"
+               << tab(3) << "static constexpr ColumnType const Type = ColumnType::" << toTypeName(type) << ";\n"
+               << tab(3) << "static constexpr " << toCppType(type) << " const* get(ColumnData const& data) { return data.as" << toTypeName(type) << "; }\n"
+               << tab(2) << "};\n\n";
+    }
+
+    output << tab(1) << "} // namespace details\n\n";
+}
+
+bool LegacyCppCodeGenerator::hasLineIndex() const
+{
+    return std::any_of(_configuration.inputs.begin(), _configuration.inputs.end(), [](Input const& input){ return input.lineIndex; });
+}
+
+bool LegacyCppCodeGenerator::hasTable() const
+{
+    return std::any_of(_configuration.inputs.begin(), _configuration.inputs.end(), [](Input const& input){ return !input.columnTypes.empty(); });
+}
+
+bool LegacyCppCodeGenerator::hasJson() const
+{
+    return std::any_of(_configuration.inputs.begin(), _configuration.inputs.end(), [](Input const& input){ return input.json; });
+}
+
+bool LegacyCppCodeGenerator::hasDictionary(DictionaryType type) const
+{
+    return std::any_of(_configuration.inputs.begin(), _configuration.inputs.end(), [type](Input const& input){ return input.dictionaryType == type; });
+}
+
+bool LegacyCppCodeGenerator::hasSideTables() const
+{
+    return hasLineIndex() || hasTable() || hasJson() || hasDictionary(DictionaryType::Map) || hasDictionary(DictionaryType::Set) || hasCompression();
+}
+
+bool LegacyCppCodeGenerator::hasCompression() const
+{
+    return std::any_of(_configuration.inputs.begin(), _configuration.inputs.end(), [](Input const& input){ return input.frameSize > 0u; });
+}
+
+/// Images are the resources whose last transform is 'png', see Image.hpp.
+bool LegacyCppCodeGenerator::hasImages() const
+{
+    return std::any_of(_configuration.inputs.begin(), _configuration.inputs.end(), [](Input const& input)
+    {
+        return getImageRowAlignment(input).has_value();
+    });
+}
+
+/// Without resources there is nothing to replace, the directive @overlay is ignored.
+bool LegacyCppCodeGenerator::hasOverlay() const
+{
+    return _configuration.overlayPath.has_value() && !_configuration.inputs.empty();
+}
+
+bool LegacyCppCodeGenerator::hasVariants() const
+{
+    return !_configuration.dimensions.empty();
 }
 
 void LegacyCppCodeGenerator::writeFileFooter(std::ostream& output) const
@@ -103,9 +506,15 @@ std::string makeResourceName(unsigned int i)
     return format("R{}", i);
 }
 
-void LegacyCppCodeGenerator::writeResource(Input const&, unsigned int inputPosition, std::vector<char> const& bytes, std::ostream& output) const
+void LegacyCppCodeGenerator::writeResource(Input const& input, unsigned int inputPosition, std::vector<char> const& bytes, std::ostream& output) const
 {
-    output << tab(2) << format("static constexpr char const {}[] = {", makeResourceName(inputPosition));
+    // The rows of an image are aligned in memory only if the resource is aligned like its first row
+    if (auto const rowAlignment = getImageRowAlignment(input); rowAlignment.has_value())
+        output << tab(2) << format("alignas({}) ", getImagePixelsOffset(*rowAlignment));
+    else
+        output << tab(2);
+
+    output << format("static constexpr char const {}[] = {", makeResourceName(inputPosition));
 
     output << std::hex;
     for (auto i = 0u; i < bytes.size(); ++i) {
@@ -129,7 +538,7 @@ void LegacyCppCodeGenerator::writeAccessFunction(std::ostream& output) const
     // The content of the function is basically a copy-paste of https://en.cppreference.com/w/cpp/algorithm/lower_bound.
     // I can't use std::lower_bound because it's not constexpr (yet, C++ adds a constexpr version, see #46).
     output << tab(1) << "namespace details {\n";
-    if (!_configuration.inputs.empty()) {
+    if (!_configuration.inputs.empty() || !_configuration.variantGroups.empty()) {
         output << tab(2) << "constexpr bool compareSlot(Resource const& slot, char const * key) { return std::string_view(slot.key) < key; }\n\n";
         output << tab(2) << "template<class ForwardIt, class Compare>\n"
                << tab(2) << "constexpr ForwardIt lowerBound(ForwardIt first, ForwardIt last, char const* value, Compare compare)\n"
@@ -143,15 +552,36 @@ void LegacyCppCodeGenerator::writeAccessFunction(std::ostream& output) const
                << tab(4) << "it = first; step = count / 2; std::advance(it, step);\n"
                << tab(4) << "if (compare(*it, value)) { first = ++it; count -= step + 1; } else { count = step; }\n"
                << tab(3) << "}\n"
-               << tab(3) << "return first->key != nullptr && std::strcmp(value, first->key) == 0 ? first : last;\n"
+               << tab(3) << "return first != last && std::strcmp(value, first->key) == 0 ? first : last;\n"
                << tab(2) << "}\n";
     }
 
     output << tab(2) << "static constexpr Resource const NullResource{nullptr, 0u, nullptr};\n";
+
+    // Side tables store additional data about resources, they are ordered like ResourcesIndex.
+    if (hasSideTables())
+    {
+        output << "\n"
+               << tab(2) << "template <typename T>\n"
+               << tab(2) << "inline constexpr T const* getSideTable(T const* const (&table)[ResourcesCount], Resource const& resource)\n"
+               << tab(2) << "{\n"
+               << tab(3) << "if (&resource == &NullResource) return nullptr;\n";
+
+        // The resources of the overlay are outside ResourcesIndex, they are stored as is so they have no side table
+        if (hasOverlay())
+        {
+            output << tab(3) << "if (std::less<Resource const*>{}(&resource, std::begin(ResourcesIndex)) || !std::less<Resource const*>{}(&resource, std::end(ResourcesIndex))) return nullptr;\n";
+        }
+        output << tab(3) << "return table[&resource - std::begin(ResourcesIndex)];\n"
+               << tab(2) << "}\n";
+    }
     output << tab(1) << "} // namespace details\n\n";
 
     output << tab(1) << "using ResourceIterator = Resource const*;\n\n";
 
+    if (hasOverlay())
+        writeOverlayFunctions(output);
+
     // Print function rescom::getResource, if no resources always returns the null resource
     if (_configuration.inputs.empty())
     {
@@ -163,13 +593,31 @@ void LegacyCppCodeGenerator::writeAccessFunction(std::ostream& output) const
     {
         output << tab() << "inline constexpr Resource const& getResource(char const* key)\n"
                << tab() << "{\n"
+               << tab(2) << "RESCOM_PROBE(probeLookupStart(key));\n"
+               << "\n"
                << tab(2) << "auto it = details::lowerBound(std::begin(details::ResourcesIndex), std::end(details::ResourcesIndex), key, details::compareSlot);\n"
                << "\n"
                << tab(2) << "if (it == std::end(details::ResourcesIndex))\n"
+               << tab(2) << "{\n"
+               << tab(3) << "RESCOM_PROBE(probeLookupMiss(key));\n"
                << tab(3) << "return details::NullResource;\n"
-               << "\n"
-               << tab(2) << "return *it;\n"
-               << tab() << "}\n";
+               << tab(2) << "}\n"
+               << "\n";
+
+        // The probe reports the size of the resource returned, which is the one of the overlay if it's replaced
+        if (hasOverlay())
+        {
+            output << tab(2) << "auto const& resource = details::overlaid(*it);\n"
+                   << "\n"
+                   << tab(2) << "RESCOM_PROBE(probeLookupHit(key, resource.size));\n"
+                   << tab(2) << "return resource;\n";
+        }
+        else
+        {
+            output << tab(2) << "RESCOM_PROBE(probeLookupHit(key, it->size));\n"
+                   << tab(2) << "return *it;\n";
+        }
+        output << tab() << "}\n";
     }
     output << "\n";
 
@@ -203,40 +651,1631 @@ void LegacyCppCodeGenerator::writeAccessFunction(std::ostream& output) const
     output << tab() << "}\n";
 }
 
-void LegacyCppCodeGenerator::writeResources(std::ostream& output) const
+/// Write the tables of the variants and the functions to access them.
+/// For each group of variants, the resource to use for each value of its dimension is resolved here, fallbacks included.
+/// At runtime getting a variant is a binary search of the key of the group followed by one access to its table.
+void LegacyCppCodeGenerator::writeVariantAccessFunctions(std::ostream& output) const
 {
-    if (_configuration.inputs.empty())
-        return;
+    auto const& inputs = _configuration.inputs;
+    auto const& dimensions = _configuration.dimensions;
+    auto const& groups = _configuration.variantGroups;
+    auto const findInput = [&inputs](std::string const& key) -> std::optional<std::size_t>
+    {
+        auto const it = std::lower_bound(inputs.begin(), inputs.end(), key, [](Input const& input, std::string const& key){ return input.key < key; });
 
-    std::vector<char> buffer;
-    std::vector<std::string_view> keys;
+        if (it == inputs.end() || it->key != key)
+            return std::nullopt;
 
-    buffer.reserve(1024 * 16);
+        return static_cast<std::size_t>(it - inputs.begin());
+    };
+
+    // Print struct rescom::VariantDimension
+    output << "\n"
+           << tab(1) << "struct VariantDimension\n"
+           << tab(1) << "{\n"
+           << tab(2) << "char const* const name;\n"
+           << tab(2) << "unsigned int const count;\n"
+           << tab(2) << "char const* const* const values;\n"
+           << tab(1) << "};\n\n";
+
+    // Print struct rescom::Variant, a value of a dimension resolved once then reused to access the variants
+    output << tab(1) << "struct Variant\n"
+           << tab(1) << "{\n"
+           << tab(2) << "unsigned int dimension;\n"
+           << tab(2) << "unsigned int value;\n"
+           << "\n"
+           << tab(2) << "constexpr bool valid() const { return dimension != ~0u; }\n"
+           << tab(1) << "};\n\n";
 
     output << tab(1) << "namespace details {\n";
-    output << tab(2) << "static constexpr unsigned int const ResourcesCount = " << _configuration.inputs.size() << ";\n";
 
-    // Write data
-    for (auto i = 0u; i < _configuration.inputs.size(); ++i)
+    for (auto i = 0u; i < dimensions.size(); ++i)
     {
-        auto const& input = _configuration.inputs[i];
-
-        loadFile(input.filePath, buffer);
-        writeResource(input, i, buffer, output);
+        output << tab(2) << format("static constexpr char const* const D{}Values[] = {", i);
+        for (auto value = 0u; value < dimensions[i].values.size(); ++value)
+            output << (value > 0u ? ", " : "") << toCppStringLiteral(dimensions[i].values[value]);
+        output << "};\n";
     }
 
-    // Write index
-    output << tab(2) << "static constexpr Resource const ResourcesIndex[ResourcesCount] = \n";
-    output << tab(2) << "{\n";
+    output << tab(2) << "static constexpr VariantDimension const Dimensions[] = \n"
+           << tab(2) << "{\n";
+    for (auto i = 0u; i < dimensions.size(); ++i)
+        output << tab(3) << format("{ {}, {}u, D{}Values },\n", toCppStringLiteral(dimensions[i].name), dimensions[i].values.size(), i);
+    output << tab(2) << "};\n";
 
-    for (auto i = 0u; i < _configuration.inputs.size(); ++i)
+    output << "\n"
+           << tab(2) << "struct VariantGroup\n"
+           << tab(2) << "{\n"
+           << tab(3) << "char const* const key;\n"
+           << tab(3) << "unsigned int const dimension;\n"
+           << tab(3) << "Resource const* const* const resources;\n"
+           << tab(2) << "};\n\n";
+
+    if (!groups.empty())
     {
-        auto const& input = _configuration.inputs[i];
-        auto resourceName = makeResourceName(i);
+        output << tab(2) << "constexpr bool compareGroup(VariantGroup const& group, char const * key) { return std::string_view(group.key) < key; }\n\n";
+
+        for (auto i = 0u; i < groups.size(); ++i)
+        {
+            auto const& dimension = dimensions[groups[i].dimension];
+            auto const resolved = resolveVariants(groups[i], dimension, findInput);
+
+            output << tab(2) << format("// {}: {}\n", groups[i].key, groups[i].pattern);
+            output << tab(2) << format("static constexpr Resource const* const G{}Resources[] = {", i);
+            for (auto value = 0u; value < resolved.size(); ++value)
+            {
+                output << (value > 0u ? ", " : "")
+                       << (resolved[value].has_value() ? format("&ResourcesIndex[{}]", *resolved[value]) : std::string{"&NullResource"});
+            }
+            output << "};\n";
+        }
+
+        output << tab(2) << "static constexpr VariantGroup const VariantGroups[] = \n"
+               << tab(2) << "{\n";
+        for (auto i = 0u; i < groups.size(); ++i)
+            output << tab(3) << format("{ {}, {}u, G{}Resources },\n", toCppStringLiteral(groups[i].key), groups[i].dimension, i);
+        output << tab(2) << "};\n\n";
+
+        output << tab(2) << "inline constexpr VariantGroup const* findVariantGroup(char const* key)\n"
+               << tab(2) << "{\n"
+               << tab(3) << "auto it = lowerBound(std::begin(VariantGroups), std::end(VariantGroups), key, compareGroup);\n"
+               << "\n"
+               << tab(3) << "return it != std::end(VariantGroups) ? it : nullptr;\n"
+               << tab(2) << "}\n";
+    }
+    else
+    {
+        output << tab(2) << "inline constexpr VariantGroup const* findVariantGroup(char const*) { return nullptr; }\n";
+    }
+    output << tab(1) << "} // namespace details\n\n";
+
+    // Print function rescom::getVariant
+    output << tab() << "/// Returns an invalid variant if the dimension or the value does not exist.\n"
+           << tab() << "inline constexpr Variant getVariant(char const* dimension, char const* value)\n"
+           << tab() << "{\n"
+           << tab(2) << "for (auto i = 0u; i < std::size(details::Dimensions); ++i)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "if (std::strcmp(details::Dimensions[i].name, dimension) != 0)\n"
+           << tab(4) << "continue;\n"
+           << "\n"
+           << tab(3) << "for (auto j = 0u; j < details::Dimensions[i].count; ++j)\n"
+           << tab(3) << "{\n"
+           << tab(4) << "if (std::strcmp(details::Dimensions[i].values[j], value) == 0)\n"
+           << tab(5) << "return Variant{i, j};\n"
+           << tab(3) << "}\n"
+           << tab(2) << "}\n"
+           << "\n"
+           << tab(2) << "return Variant{~0u, ~0u};\n"
+           << tab() << "}\n\n";
+
+    // Print functions rescom::getResource and rescom::getText taking a variant
+    output << tab() << "inline constexpr Resource const& getResource(char const* key, Variant variant)\n"
+           << tab() << "{\n"
+           << tab(2) << "auto const* group = details::findVariantGroup(key);\n"
+           << "\n"
+           << tab(2) << "if (group == nullptr || group->dimension != variant.dimension)\n"
+           << tab(3) << "return details::NullResource;\n"
+           << "\n"
+           << tab(2) << (hasOverlay() ? "return details::overlaid(*group->resources[variant.value]);\n" : "return *group->resources[variant.value];\n")
+           << tab() << "}\n\n"
+           << tab() << "inline constexpr Resource const& getResource(char const* key, char const* variant)\n"
+           << tab() << "{\n"
+           << tab(2) << "auto const* group = details::findVariantGroup(key);\n"
+           << "\n"
+           << tab(2) << "if (group == nullptr || variant == nullptr)\n"
+           << tab(3) << "return details::NullResource;\n"
+           << "\n"
+           << tab(2) << "auto const& dimension = details::Dimensions[group->dimension];\n"
+           << "\n"
+           << tab(2) << "for (auto i = 0u; i < dimension.count; ++i)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "if (std::strcmp(dimension.values[i], variant) == 0)\n"
+           << tab(4) << (hasOverlay() ? "return details::overlaid(*group->resources[i]);\n" : "return *group->resources[i];\n")
+           << tab(2) << "}\n"
+           << "\n"
+           << tab(2) << "return details::NullResource;\n"
+           << tab() << "}\n\n"
+           << tab() << "template <typename V>\n"
+           << tab() << "inline constexpr std::string_view getText(char const* key, V variant)\n"
+           << tab() << "{\n"
+           << tab(2) << "auto const& resource = getResource(key, variant);\n"
+           << "\n"
+           << tab(2) << "return std::string_view{resource.bytes, resource.size};\n"
+           << tab() << "}\n";
+}
 
-        output << tab(3) << "{\"" << input.key << "\", " << input.size << ", " << resourceName << "},\n";
+template <typename T>
+void writeArray(std::ostream& output, std::vector<T> const& values)
+{
+    for (auto i = 0u; i < values.size(); ++i) {
+        if (i > 0u)
+            output << ", ";
+        output << values[i] << "u";
     }
+}
+
+std::string makeCompressedResourceName(unsigned int i, std::string const& suffix)
+{
+    return format("R{}Compressed{}", i, suffix);
+}
+
+void LegacyCppCodeGenerator::writeCompressedResource(Input const&, unsigned int inputPosition, std::size_t size, CompressedFrames const& frames, std::ostream& output) const
+{
+    output << tab(2) << format("static constexpr unsigned int const {}[] = {", makeCompressedResourceName(inputPosition, "Offsets"));
+    writeArray(output, frames.offsets);
+    output << "};\n";
+    output << tab(2) << format("static constexpr CompressedResource const {}{ {}u, {}u, {}u, {} };\n",
+                               makeCompressedResourceName(inputPosition, ""),
+                               size,
+                               frames.frameSize,
+                               frames.offsets.size() - 1u,
+                               makeCompressedResourceName(inputPosition, "Offsets"));
+}
+
+/// Write the class Reader, reading any resource by slices.
+/// Only the frames containing the bytes read are decoded, the memory used is bounded by one frame.
+void LegacyCppCodeGenerator::writeReader(std::ostream& output) const
+{
+    output << "\n"
+           << tab(1) << "class Reader\n"
+           << tab(1) << "{\n"
+           << tab(2) << "Resource const* _resource;\n"
+           << tab(2) << "details::CompressedResource const* _compressed;\n"
+           << tab(2) << "std::vector<char> _frame;\n"
+           << tab(2) << "unsigned int _frameIndex = ~0u;\n"
+           << tab(2) << "std::size_t _position = 0u;\n"
+           << "\n"
+           << tab(2) << "std::size_t frameLength(unsigned int index) const\n"
+           << tab(2) << "{\n"
+           << tab(3) << "auto const begin = std::size_t{index} * frameSize();\n"
+           << "\n"
+           << tab(3) << "return size() - begin < frameSize() ? size() - begin : frameSize();\n"
+           << tab(2) << "}\n"
+           << tab(1) << "public:\n"
+           << tab(2) << "explicit Reader(char const* key)\n"
+           << tab(2) << ": _resource(&getResource(key))\n"
+           << tab(2) << ", _compressed(details::getSideTable(details::CompressedResources, *_resource))\n"
+           << tab(2) << "{\n"
+           << tab(2) << "}\n"
+           << "\n"
+           << tab(2) << "bool valid() const { return _resource->key != nullptr; }\n"
+           << tab(2) << "/// Size of the resource once decoded\n"
+           << tab(2) << "std::size_t size() const { return _compressed != nullptr ? _compressed->size : _resource->size; }\n"
+           << tab(2) << "std::size_t frameSize() const { return _compressed != nullptr ? _compressed->frameSize : _resource->size; }\n"
+           << tab(2) << "unsigned int frameCount() const { return _compressed != nullptr ? _compressed->frameCount : (_resource->size > 0u ? 1u : 0u); }\n"
+           << "\n"
+           << tab(2) << "/// Decode the frame 'index' into 'destination' which must be able to store frameSize() bytes.\n"
+           << tab(2) << "/// Returns the size of the frame. Frames are independent, they can be decoded in parallel.\n"
+           << tab(2) << "std::size_t decodeFrame(unsigned int index, char* destination) const\n"
+           << tab(2) << "{\n"
+           << tab(3) << "auto const length = frameLength(index);\n"
+           << "\n"
+           << tab(3) << "if (_compressed == nullptr)\n"
+           << tab(4) << "std::memcpy(destination, _resource->bytes + std::size_t{index} * frameSize(), length);\n"
+           << tab(3) << "else\n"
+           << tab(3) << "{\n"
+           << tab(4) << "RESCOM_PROBE(probeDecompressStart(_resource->key, index));\n"
+           << tab(4) << "details::decodeFrame(reinterpret_cast<unsigned char const*>(_resource->bytes) + _compressed->offsets[index],\n"
+           << tab(4) << "                     reinterpret_cast<unsigned char const*>(_resource->bytes) + _compressed->offsets[index + 1u],\n"
+           << tab(4) << "                     destination);\n"
+           << tab(4) << "RESCOM_PROBE(probeDecompressDone(_resource->key, index, length));\n"
+           << tab(3) << "}\n"
+           << tab(3) << "return length;\n"
+           << tab(2) << "}\n"
+           << "\n"
+           << tab(2) << "/// Copy at most 'length' bytes starting at 'offset' into 'destination'.\n"
+           << tab(2) << "/// Returns the count of bytes copied.\n"
+           << tab(2) << "std::size_t read(std::size_t offset, std::size_t length, char* destination)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "if (offset >= size())\n"
+           << tab(4) << "return 0u;\n"
+           << "\n"
+           << tab(3) << "if (length > size() - offset)\n"
+           << tab(4) << "length = size() - offset;\n"
+           << "\n"
+           << tab(3) << "if (_compressed == nullptr)\n"
+           << tab(3) << "{\n"
+           << tab(4) << "std::memcpy(destination, _resource->bytes + offset, length);\n"
+           << tab(4) << "return length;\n"
+           << tab(3) << "}\n"
+           << "\n"
+           << tab(3) << "for (std::size_t copied = 0u; copied < length;)\n"
+           << tab(3) << "{\n"
+           << tab(4) << "auto const index = static_cast<unsigned int>((offset + copied) / frameSize());\n"
+           << tab(4) << "auto const frameOffset = offset + copied - std::size_t{index} * frameSize();\n"
+           << tab(4) << "auto const available = frameLength(index) - frameOffset;\n"
+           << tab(4) << "auto const count = available < length - copied ? available : length - copied;\n"
+           << "\n"
+           << tab(4) << "// A whole frame is decoded directly into the destination\n"
+           << tab(4) << "if (count == frameLength(index))\n"
+           << tab(4) << "{\n"
+           << tab(5) << "decodeFrame(index, destination + copied);\n"
+           << tab(4) << "}\n"
+           << tab(4) << "else\n"
+           << tab(4) << "{\n"
+           << tab(5) << "if (index != _frameIndex)\n"
+           << tab(5) << "{\n"
+           << tab(6) << "_frame.resize(frameSize());\n"
+           << tab(6) << "decodeFrame(index, _frame.data());\n"
+           << tab(6) << "_frameIndex = index;\n"
+           << tab(5) << "}\n"
+           << tab(5) << "std::memcpy(destination + copied, _frame.data() + frameOffset, count);\n"
+           << tab(4) << "}\n"
+           << tab(4) << "copied += count;\n"
+           << tab(3) << "}\n"
+           << "\n"
+           << tab(3) << "return length;\n"
+           << tab(2) << "}\n"
+           << "\n"
+           << tab(2) << "/// Read the next bytes of the resource, returns the count of bytes copied.\n"
+           << tab(2) << "std::size_t read(char* destination, std::size_t length)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "auto const count = read(_position, length, destination);\n"
+           << "\n"
+           << tab(3) << "_position += count;\n"
+           << tab(3) << "return count;\n"
+           << tab(2) << "}\n"
+           << "\n"
+           << tab(2) << "void seek(std::size_t position) { _position = position; }\n"
+           << tab(2) << "std::size_t tell() const { return _position; }\n"
+           << tab(2) << "bool eof() const { return _position >= size(); }\n"
+           << tab(1) << "};\n";
+}
+
+/// Write the cache of decoded resources and the function rescom::cached.
+/// There is one slot per resource and per type of decoded object. A hit never locks: the reader registers itself
+/// in the slot while copying the value, the eviction (done with the mutex of the cache locked) removes the entry
+/// from its slot then waits for the readers registered before deleting it.
+void LegacyCppCodeGenerator::writeCacheFunctions(std::ostream& output) const
+{
+    // Print struct rescom::CacheStatistics
+    output << "\n"
+           << tab(1) << "struct CacheStatistics\n"
+           << tab(1) << "{\n"
+           << tab(2) << "std::uint64_t hits;\n"
+           << tab(2) << "std::uint64_t misses;\n"
+           << tab(2) << "std::uint64_t evictions;\n"
+           << tab(2) << "std::size_t entries;\n"
+           << tab(2) << "std::size_t bytes;\n"
+           << tab(2) << "std::size_t budget;\n"
+           << tab(1) << "};\n\n";
+
+    output << tab(1) << "namespace details {\n"
+           << tab(2) << "struct CacheSlot;\n\n"
+           << tab(2) << "struct CacheEntry\n"
+           << tab(2) << "{\n"
+           << tab(3) << "CacheSlot* const slot;\n"
+           << tab(3) << "std::size_t const bytes;\n"
+           << tab(3) << "std::shared_ptr<void const> const value;\n"
+           << tab(3) << "std::atomic<std::uint64_t> lastUse;\n"
+           << "\n"
+           << tab(3) << "CacheEntry(CacheSlot* slot, std::size_t bytes, std::shared_ptr<void const> value, std::uint64_t lastUse)\n"
+           << tab(3) << ": slot(slot), bytes(bytes), value(std::move(value)), lastUse(lastUse) {}\n"
+           << tab(2) << "};\n\n"
+           << tab(2) << "struct CacheSlot\n"
+           << tab(2) << "{\n"
+           << tab(3) << "std::atomic<CacheEntry*> entry{nullptr};\n"
+           << tab(3) << "std::atomic<unsigned int> readers{0u};\n"
+           << tab(3) << "std::mutex decoding;\n"
+           << tab(2) << "};\n\n"
+           << tab(2) << "struct Cache\n"
+           << tab(2) << "{\n"
+           << tab(3) << "std::mutex mutex;\n"
+           << tab(3) << "std::vector<CacheEntry*> entries;\n"
+           << tab(3) << "std::size_t bytes = 0u;\n"
+           << tab(3) << "std::size_t budget = " << *_configuration.runtimeCacheBudget << "u;\n"
+           << tab(3) << "std::atomic<std::uint64_t> clock{0u};\n"
+           << tab(3) << "std::atomic<std::uint64_t> hits{0u};\n"
+           << tab(3) << "std::atomic<std::uint64_t> misses{0u};\n"
+           << tab(3) << "std::atomic<std::uint64_t> evictions{0u};\n"
+           << "\n"
+           << tab(3) << "~Cache() { for (auto* entry : entries) delete entry; }\n"
+           << tab(2) << "};\n\n"
+           << tab(2) << "inline Cache& cache()\n"
+           << tab(2) << "{\n"
+           << tab(3) << "static Cache instance;\n"
+           << "\n"
+           << tab(3) << "return instance;\n"
+           << tab(2) << "}\n\n";
+
+    // The default cost of a container includes its elements
+    output << tab(2) << "template <typename T, typename = void>\n"
+           << tab(2) << "struct CacheCost\n"
+           << tab(2) << "{\n"
+           << tab(3) << "static std::size_t of(T const&) { return sizeof(T); }\n"
+           << tab(2) << "};\n\n"
+           << tab(2) << "template <typename T>\n"
+           << tab(2) << "struct CacheCost<T, std::void_t<typename T::value_type, decltype(std::declval<T const&>().size())>>\n"
+           << tab(2) << "{\n"
+           << tab(3) << "static std::size_t of(T const& value) { return sizeof(T) + value.size() * sizeof(typename T::value_type); }\n"
+           << tab(2) << "};\n\n";
+
+    // Print the functions accessing to the entries
+    output << tab(2) << "inline std::shared_ptr<void const> findCacheEntry(Cache& cache, CacheSlot& slot)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "std::shared_ptr<void const> value;\n"
+           << "\n"
+           << tab(3) << "slot.readers.fetch_add(1u);\n"
+           << tab(3) << "if (auto* entry = slot.entry.load(); entry != nullptr)\n"
+           << tab(3) << "{\n"
+           << tab(4) << "entry->lastUse.store(cache.clock.fetch_add(1u, std::memory_order_relaxed), std::memory_order_relaxed);\n"
+           << tab(4) << "value = entry->value;\n"
+           << tab(3) << "}\n"
+           << tab(3) << "slot.readers.fetch_sub(1u);\n"
+           << "\n"
+           << tab(3) << "if (value != nullptr)\n"
+           << tab(4) << "cache.hits.fetch_add(1u, std::memory_order_relaxed);\n"
+           << "\n"
+           << tab(3) << "return value;\n"
+           << tab(2) << "}\n\n"
+           << tab(2) << "/// The mutex of the cache must be locked.\n"
+           << tab(2) << "inline void evictCacheEntry(Cache& cache, std::size_t position)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "auto* entry = cache.entries[position];\n"
+           << "\n"
+           << tab(3) << "entry->slot->entry.store(nullptr);\n"
+           << tab(3) << "while (entry->slot->readers.load() != 0u)\n"
+           << tab(4) << "std::this_thread::yield();\n"
+           << "\n"
+           << tab(3) << "cache.bytes -= entry->bytes;\n"
+           << tab(3) << "cache.entries.erase(cache.entries.begin() + static_cast<std::ptrdiff_t>(position));\n"
+           << tab(3) << "cache.evictions.fetch_add(1u, std::memory_order_relaxed);\n"
+           << tab(3) << "delete entry;\n"
+           << tab(2) << "}\n\n"
+           << tab(2) << "/// Evict the least recently used entries until the cache uses at most 'budget' bytes.\n"
+           << tab(2) << "/// The mutex of the cache must be locked.\n"
+           << tab(2) << "inline void shrinkCache(Cache& cache, std::size_t budget)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "while (cache.bytes > budget && !cache.entries.empty())\n"
+           << tab(3) << "{\n"
+           << tab(4) << "std::size_t oldest = 0u;\n"
+           << "\n"
+           << tab(4) << "for (auto i = 1u; i < cache.entries.size(); ++i)\n"
+           << tab(4) << "{\n"
+           << tab(5) << "if (cache.entries[i]->lastUse.load(std::memory_order_relaxed) < cache.entries[oldest]->lastUse.load(std::memory_order_relaxed))\n"
+           << tab(6) << "oldest = i;\n"
+           << tab(4) << "}\n"
+           << tab(4) << "evictCacheEntry(cache, oldest);\n"
+           << tab(3) << "}\n"
+           << tab(2) << "}\n";
+
+    if (!_configuration.inputs.empty())
+    {
+        output << "\n"
+               << tab(2) << "template <typename T>\n"
+               << tab(2) << "inline CacheSlot CacheSlots[ResourcesCount];\n";
+    }
+    output << tab(1) << "} // namespace details\n\n";
+
+    // Print function rescom::cached
+    output << tab() << "/// Returns the object decoded from the resource 'key' by 'decoder', a function taking a std::string_view and returning a T.\n"
+           << tab() << "/// The resource is decoded once then the object is kept in the cache until it's evicted. 'cost' returns the size\n"
+           << tab() << "/// of the object in bytes. Returns nullptr if the resource does not exist.\n"
+           << tab() << "template <typename T, typename Decoder, typename Cost>\n"
+           << tab() << "std::shared_ptr<T const> cached(char const* key, Decoder&& decoder, Cost&& cost)\n"
+           << tab() << "{\n";
+    if (_configuration.inputs.empty())
+    {
+        output << tab(2) << "static_cast<void>(key);\n"
+               << tab(2) << "static_cast<void>(decoder);\n"
+               << tab(2) << "static_cast<void>(cost);\n"
+               << tab(2) << "return nullptr;\n";
+    }
+    else
+    {
+        output << tab(2) << "auto const& resource = getResource(key);\n"
+               << "\n"
+               << tab(2) << "if (&resource == &details::NullResource)\n"
+               << tab(3) << "return nullptr;\n"
+               << "\n"
+               << tab(2) << "auto& cache = details::cache();\n"
+               << tab(2) << (hasOverlay() ? "auto& slot = details::CacheSlots<T>[details::indexOf(resource)];\n"
+                                          : "auto& slot = details::CacheSlots<T>[&resource - std::begin(details::ResourcesIndex)];\n")
+               << "\n"
+               << tab(2) << "if (auto value = details::findCacheEntry(cache, slot); value != nullptr)\n"
+               << tab(2) << "{\n"
+               << tab(3) << "RESCOM_PROBE(probeCacheHit(resource.key));\n"
+               << tab(3) << "return std::static_pointer_cast<T const>(value);\n"
+               << tab(2) << "}\n"
+               << "\n"
+               << tab(2) << "// Only one thread decodes the resource, the others wait then find it in the cache\n"
+               << tab(2) << "std::lock_guard<std::mutex> decodingLock{slot.decoding};\n"
+               << "\n"
+               << tab(2) << "if (auto value = details::findCacheEntry(cache, slot); value != nullptr)\n"
+               << tab(2) << "{\n"
+               << tab(3) << "RESCOM_PROBE(probeCacheHit(resource.key));\n"
+               << tab(3) << "return std::static_pointer_cast<T const>(value);\n"
+               << tab(2) << "}\n"
+               << "\n"
+               << tab(2) << "RESCOM_PROBE(probeDecodeStart(resource.key, resource.size));\n"
+               << tab(2) << "std::shared_ptr<T const> value = std::make_shared<T const>(decoder(std::string_view{resource.bytes, resource.size}));\n"
+               << tab(2) << "std::size_t const bytes = cost(*value);\n"
+               << tab(2) << "RESCOM_PROBE(probeDecodeDone(resource.key, bytes));\n"
+               << tab(2) << "std::lock_guard<std::mutex> lock{cache.mutex};\n"
+               << "\n"
+               << tab(2) << "cache.misses.fetch_add(1u, std::memory_order_relaxed);\n"
+               << tab(2) << "// An object larger than the budget is not kept\n"
+               << tab(2) << "if (bytes <= cache.budget)\n"
+               << tab(2) << "{\n"
+               << tab(3) << "details::shrinkCache(cache, cache.budget - bytes);\n"
+               << tab(3) << "cache.entries.push_back(new details::CacheEntry{&slot, bytes, value, cache.clock.fetch_add(1u, std::memory_order_relaxed)});\n"
+               << tab(3) << "cache.bytes += bytes;\n"
+               << tab(3) << "slot.entry.store(cache.entries.back());\n"
+               << tab(2) << "}\n"
+               << "\n"
+               << tab(2) << "return value;\n";
+    }
+    output << tab() << "}\n\n"
+           << tab() << "template <typename T, typename Decoder>\n"
+           << tab() << "std::shared_ptr<T const> cached(char const* key, Decoder&& decoder)\n"
+           << tab() << "{\n"
+           << tab(2) << "return cached<T>(key, std::forward<Decoder>(decoder), details::CacheCost<T>::of);\n"
+           << tab() << "}\n\n";
+
+    // Print the functions managing the cache
+    output << tab() << "inline CacheStatistics cacheStatistics()\n"
+           << tab() << "{\n"
+           << tab(2) << "auto& cache = details::cache();\n"
+           << tab(2) << "std::lock_guard<std::mutex> lock{cache.mutex};\n"
+           << "\n"
+           << tab(2) << "return CacheStatistics{cache.hits.load(), cache.misses.load(), cache.evictions.load(), cache.entries.size(), cache.bytes, cache.budget};\n"
+           << tab() << "}\n\n"
+           << tab() << "/// Evict the least recently used objects if the cache does not fit in the new budget.\n"
+           << tab() << "inline void setCacheBudget(std::size_t budget)\n"
+           << tab() << "{\n"
+           << tab(2) << "auto& cache = details::cache();\n"
+           << tab(2) << "std::lock_guard<std::mutex> lock{cache.mutex};\n"
+           << "\n"
+           << tab(2) << "cache.budget = budget;\n"
+           << tab(2) << "details::shrinkCache(cache, budget);\n"
+           << tab() << "}\n\n"
+           << tab() << "inline void clearCache()\n"
+           << tab() << "{\n"
+           << tab(2) << "auto& cache = details::cache();\n"
+           << tab(2) << "std::lock_guard<std::mutex> lock{cache.mutex};\n"
+           << "\n"
+           << tab(2) << "while (!cache.entries.empty())\n"
+           << tab(3) << "details::evictCacheEntry(cache, cache.entries.size() - 1u);\n"
+           << tab() << "}\n";
+}
+
+/// Write the struct details::MappedArchive and the function details::mapArchive, used by the archives and the overlays.
+void LegacyCppCodeGenerator::writeArchiveMapping(std::ostream& output) const
+{
+    output << "\n"
+           << tab(1) << "namespace details {\n"
+           << tab(2) << "struct Crc32Table\n"
+           << tab(2) << "{\n"
+           << tab(3) << "std::uint32_t values[256];\n"
+           << tab(2) << "};\n\n"
+           << tab(2) << "constexpr Crc32Table makeCrc32Table()\n"
+           << tab(2) << "{\n"
+           << tab(3) << "Crc32Table table{};\n"
+           << "\n"
+           << tab(3) << "for (std::uint32_t i = 0u; i < 256u; ++i)\n"
+           << tab(3) << "{\n"
+           << tab(4) << "std::uint32_t value = i;\n"
+           << "\n"
+           << tab(4) << "for (auto bit = 0u; bit < 8u; ++bit)\n"
+           << tab(5) << "value = (value & 1u) != 0u ? 0xEDB88320u ^ (value >> 1u) : value >> 1u;\n"
+           << "\n"
+           << tab(4) << "table.values[i] = value;\n"
+           << tab(3) << "}\n"
+           << "\n"
+           << tab(3) << "return table;\n"
+           << tab(2) << "}\n\n"
+           << tab(2) << "inline std::uint32_t computeCrc32(char const* bytes, std::size_t size)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "static constexpr Crc32Table const table = makeCrc32Table();\n"
+           << tab(3) << "std::uint32_t crc = ~0u;\n"
+           << "\n"
+           << tab(3) << "for (std::size_t i = 0u; i < size; ++i)\n"
+           << tab(4) << "crc = table.values[(crc ^ static_cast<unsigned char>(bytes[i])) & 0xFFu] ^ (crc >> 8u);\n"
+           << "\n"
+           << tab(3) << "return ~crc;\n"
+           << tab(2) << "}\n\n"
+           << tab(2) << "inline std::size_t readArchiveInteger(char const* bytes, unsigned int size)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "std::uint64_t value = 0u;\n"
+           << "\n"
+           << tab(3) << "for (auto i = 0u; i < size; ++i)\n"
+           << tab(4) << "value |= static_cast<std::uint64_t>(static_cast<unsigned char>(bytes[i])) << (i * 8u);\n"
+           << "\n"
+           << tab(3) << "return static_cast<std::size_t>(value);\n"
+           << tab(2) << "}\n\n";
+
+    // Print struct details::MappedArchive, see Archive.hpp for the layout
+    output << tab(2) << "struct MappedArchive\n"
+           << tab(2) << "{\n"
+           << tab(3) << "static constexpr std::size_t const HeaderSize = 64u;\n"
+           << tab(3) << "static constexpr std::size_t const EntrySize = 64u;\n"
+           << "\n"
+           << tab(3) << "char const* data = nullptr;\n"
+           << tab(3) << "std::size_t size = 0u;\n"
+           << tab(3) << "char const* entries = nullptr;\n"
+           << tab(3) << "char const* keys = nullptr;\n"
+           << tab(3) << "std::uint32_t count = 0u;\n"
+           << tab(3) << "std::uint64_t generation = 0u;\n";
+    if (_configuration.externalArchive)
+        output << tab(3) << "/// Count of the ArchiveSnapshot using the archive\n"
+               << tab(3) << "std::atomic<unsigned int> snapshots{0u};\n";
+    output << "#if defined(_WIN32)\n"
+           << tab(3) << "std::vector<char> buffer;\n"
+           << "#endif\n"
+           << "\n"
+           << tab(3) << "MappedArchive() = default;\n"
+           << tab(3) << "MappedArchive(MappedArchive const&) = delete;\n"
+           << tab(3) << "MappedArchive& operator=(MappedArchive const&) = delete;\n"
+           << "#if !defined(_WIN32)\n"
+           << tab(3) << "~MappedArchive() { if (data != nullptr) ::munmap(const_cast<char*>(data), size); }\n"
+           << "#endif\n"
+           << "\n"
+           << tab(3) << "char const* entry(std::uint32_t i) const { return entries + i * EntrySize; }\n"
+           << tab(3) << "std::string_view key(std::uint32_t i) const { return std::string_view{keys + readArchiveInteger(entry(i) + 16u, 4u), readArchiveInteger(entry(i) + 20u, 4u)}; }\n"
+           << tab(3) << "std::string_view payload(std::uint32_t i) const { return std::string_view{data + readArchiveInteger(entry(i), 8u), readArchiveInteger(entry(i) + 8u, 8u)}; }\n"
+           << "\n"
+           << tab(3) << "/// Returns 'count' if the key does not exist.\n"
+           << tab(3) << "std::uint32_t find(std::string_view key) const\n"
+           << tab(3) << "{\n"
+           << tab(4) << "std::uint32_t first = 0u;\n"
+           << tab(4) << "std::uint32_t length = count;\n"
+           << "\n"
+           << tab(4) << "while (length > 0u) {\n"
+           << tab(5) << "auto const step = length / 2u;\n"
+           << tab(5) << "if (this->key(first + step) < key) { first += step + 1u; length -= step + 1u; } else { length = step; }\n"
+           << tab(4) << "}\n"
+           << tab(4) << "return first < count && this->key(first) == key ? first : count;\n"
+           << tab(3) << "}\n"
+           << "\n"
+           << tab(3) << "/// Returns 0 if the header stored in 'slot' is not valid.\n"
+           << tab(3) << "std::uint64_t headerGeneration(std::size_t slot) const\n"
+           << tab(3) << "{\n"
+           << tab(4) << "auto const* header = data + slot * HeaderSize;\n"
+           << "\n"
+           << tab(4) << "if (size < HeaderSize * 2u || std::string_view{header, 4u} != \"RSCA\" || readArchiveInteger(header + 4u, 4u) != 1u)\n"
+           << tab(5) << "return 0u;\n"
+           << "\n"
+           << tab(4) << "if (readArchiveInteger(header + HeaderSize - 4u, 4u) != computeCrc32(header, HeaderSize - 4u))\n"
+           << tab(5) << "return 0u;\n"
+           << "\n"
+           << tab(4) << "return readArchiveInteger(header + 32u, 8u);\n"
+           << tab(3) << "}\n"
+           << "\n"
+           << tab(3) << "/// Verify the header, the index and the checksums of the payloads before the archive is used.\n"
+           << tab(3) << "/// The newest header is tried first. If the archive was updated while it was mapped, the newest header can refer\n"
+           << tab(3) << "/// to an index beyond the mapping, then the previous header is used.\n"
+           << tab(3) << "bool validate()\n"
+           << tab(3) << "{\n"
+           << tab(4) << "std::size_t const newest = headerGeneration(1u) > headerGeneration(0u) ? 1u : 0u;\n"
+           << "\n"
+           << tab(4) << "return validate(newest) || validate(1u - newest);\n"
+           << tab(3) << "}\n"
+           << "\n"
+           << tab(3) << "bool validate(std::size_t slot)\n"
+           << tab(3) << "{\n"
+           << tab(4) << "auto const* header = data + slot * HeaderSize;\n"
+           << "\n"
+           << tab(4) << "if (headerGeneration(slot) == 0u)\n"
+           << tab(5) << "return false;\n"
+           << "\n"
+           << tab(4) << "auto const indexOffset = readArchiveInteger(header + 8u, 8u);\n"
+           << tab(4) << "auto const indexSize = readArchiveInteger(header + 16u, 8u);\n"
+           << tab(4) << "auto const entryCount = readArchiveInteger(header + 24u, 4u);\n"
+           << "\n"
+           << tab(4) << "if (indexOffset > size || indexSize > size - indexOffset || entryCount * EntrySize > indexSize)\n"
+           << tab(5) << "return false;\n"
+           << "\n"
+           << tab(4) << "if (readArchiveInteger(header + 28u, 4u) != computeCrc32(data + indexOffset, indexSize))\n"
+           << tab(5) << "return false;\n"
+           << "\n"
+           << tab(4) << "auto const keysSize = indexSize - entryCount * EntrySize;\n"
+           << "\n"
+           << tab(4) << "entries = data + indexOffset;\n"
+           << tab(4) << "keys = entries + entryCount * EntrySize;\n"
+           << tab(4) << "count = static_cast<std::uint32_t>(entryCount);\n"
+           << "\n"
+           << tab(4) << "for (std::uint32_t i = 0u; i < count; ++i)\n"
+           << tab(4) << "{\n"
+           << tab(5) << "auto const offset = readArchiveInteger(entry(i), 8u);\n"
+           << tab(5) << "auto const length = readArchiveInteger(entry(i) + 8u, 8u);\n"
+           << tab(5) << "auto const keyOffset = readArchiveInteger(entry(i) + 16u, 4u);\n"
+           << tab(5) << "auto const keySize = readArchiveInteger(entry(i) + 20u, 4u);\n"
+           << "\n"
+           << tab(5) << "if (keyOffset > keysSize || keySize >= keysSize - keyOffset || keys[keyOffset + keySize] != '\\0')\n"
+           << tab(6) << "return false;\n"
+           << "\n"
+           << tab(5) << "// The keys must be ordered for the binary search\n"
+           << tab(5) << "if (i > 0u && !(key(i - 1u) < key(i)))\n"
+           << tab(6) << "return false;\n"
+           << "\n"
+           << tab(5) << "if (offset > size || length > size - offset || readArchiveInteger(entry(i) + 24u, 4u) != computeCrc32(data + offset, length))\n"
+           << tab(6) << "return false;\n"
+           << tab(4) << "}\n"
+           << "\n"
+           << tab(4) << "return true;\n"
+           << tab(3) << "}\n"
+           << tab(2) << "};\n\n";
+
+    // Print function details::mapArchive
+    output << tab(2) << "/// Returns nullptr if the file can't be read or is not a valid archive.\n"
+           << tab(2) << "inline std::unique_ptr<MappedArchive> mapArchive(char const* path)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "auto archive = std::make_unique<MappedArchive>();\n"
+           << "#if defined(_WIN32)\n"
+           << tab(3) << "// The archive is read in memory, mapping the file is implemented only for POSIX systems\n"
+           << tab(3) << "std::ifstream file{path, std::ios::binary};\n"
+           << "\n"
+           << tab(3) << "archive->buffer.assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});\n"
+           << tab(3) << "archive->data = archive->buffer.data();\n"
+           << tab(3) << "archive->size = archive->buffer.size();\n"
+           << "#else\n"
+           << tab(3) << "int const descriptor = ::open(path, O_RDONLY);\n"
+           << tab(3) << "struct stat status{};\n"
+           << "\n"
+           << tab(3) << "if (descriptor >= 0 && ::fstat(descriptor, &status) == 0 && status.st_size > 0)\n"
+           << tab(3) << "{\n"
+           << tab(4) << "void* data = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);\n"
+           << "\n"
+           << tab(4) << "if (data != MAP_FAILED)\n"
+           << tab(4) << "{\n"
+           << tab(5) << "archive->data = static_cast<char const*>(data);\n"
+           << tab(5) << "archive->size = static_cast<std::size_t>(status.st_size);\n"
+           << tab(4) << "}\n"
+           << tab(3) << "}\n"
+           << "\n"
+           << tab(3) << "if (descriptor >= 0)\n"
+           << tab(4) << "::close(descriptor);\n"
+           << "#endif\n"
+           << "\n"
+           << tab(3) << "if (archive->data == nullptr || !archive->validate())\n"
+           << tab(4) << "return nullptr;\n"
+           << "\n"
+           << tab(3) << "return archive;\n"
+           << tab(2) << "}\n"
+           << tab(1) << "} // namespace details\n";
+}
+
+/// Write the code loading external archives and the function rescom::reload.
+/// The archive in use is replaced with a RCU scheme. A snapshot registers in the counter of the current epoch only
+/// while it takes the current archive and increments the count of snapshots of that archive. reload() publishes the
+/// new archive, moves to the next epoch and retires the previous archive without waiting. A retired archive is
+/// deleted once no snapshot can take it anymore (both counters of epochs seen empty) and none uses it, by reload()
+/// or by the destruction of its last snapshot. Readers never lock and reload() never waits for them.
+void LegacyCppCodeGenerator::writeArchiveFunctions(std::ostream& output) const
+{
+    // The overlay already needed the mapping, before rescom::getResource
+    if (!hasOverlay())
+        writeArchiveMapping(output);
+
+    output << "\n"
+           << tab(1) << "namespace details {\n"
+           << tab(2) << "struct ArchiveState\n"
+           << tab(2) << "{\n"
+           << tab(3) << "std::atomic<MappedArchive*> current{nullptr};\n"
+           << tab(3) << "std::atomic<std::uint64_t> epoch{0u};\n"
+           << tab(3) << "std::atomic<unsigned int> readers[2]{};\n"
+           << tab(3) << "std::mutex writer;\n"
+           << tab(3) << "std::uint64_t generation = 0u;\n"
+           << tab(3) << "/// Archives replaced but maybe still used by snapshots, the writer mutex must be locked\n"
+           << tab(3) << "std::vector<MappedArchive*> retired;\n"
+           << "\n"
+           << tab(3) << "~ArchiveState()\n"
+           << tab(3) << "{\n"
+           << tab(4) << "delete current.load();\n"
+           << tab(4) << "for (auto* archive : retired)\n"
+           << tab(5) << "delete archive;\n"
+           << tab(3) << "}\n"
+           << tab(2) << "};\n\n"
+           << tab(2) << "inline ArchiveState& archiveState()\n"
+           << tab(2) << "{\n"
+           << tab(3) << "static ArchiveState instance;\n"
+           << "\n"
+           << tab(3) << "return instance;\n"
+           << tab(2) << "}\n\n"
+           << tab(2) << "/// Delete the retired archives no snapshot uses anymore. The writer mutex must be locked.\n"
+           << tab(2) << "inline void deleteRetiredArchives(ArchiveState& state)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "// A registered reader may be taking a retired archive. Once both counters were seen empty after the\n"
+           << tab(3) << "// archive was retired, no reader can take it anymore and its count of snapshots only decreases.\n"
+           << tab(3) << "if (state.readers[0].load() != 0u || state.readers[1].load() != 0u)\n"
+           << tab(4) << "return;\n"
+           << "\n"
+           << tab(3) << "auto const unused = std::partition(state.retired.begin(), state.retired.end(), [](MappedArchive const* archive){ return archive->snapshots.load() != 0u; });\n"
+           << "\n"
+           << tab(3) << "for (auto it = unused; it != state.retired.end(); ++it)\n"
+           << tab(4) << "delete *it;\n"
+           << tab(3) << "state.retired.erase(unused, state.retired.end());\n"
+           << tab(2) << "}\n"
+           << tab(1) << "} // namespace details\n\n";
+
+    // Print class rescom::ArchiveSnapshot
+    output << tab(1) << "/// Pins the archive in use when the snapshot is created. The views returned stay valid while the snapshot exists,\n"
+           << tab(1) << "/// even if another archive is loaded meanwhile. Creating or destroying a snapshot never waits, and a thread\n"
+           << tab(1) << "/// may call reload() while it holds snapshots.\n"
+           << tab(1) << "class ArchiveSnapshot\n"
+           << tab(1) << "{\n"
+           << tab(2) << "details::MappedArchive* _archive = nullptr;\n"
+           << tab(1) << "public:\n"
+           << tab(2) << "ArchiveSnapshot()\n"
+           << tab(2) << "{\n"
+           << tab(3) << "auto& state = details::archiveState();\n"
+           << "\n"
+           << tab(3) << "for (;;)\n"
+           << tab(3) << "{\n"
+           << tab(4) << "auto const epoch = state.epoch.load();\n"
+           << tab(4) << "auto& readers = state.readers[epoch % 2u];\n"
+           << "\n"
+           << tab(4) << "readers.fetch_add(1u);\n"
+           << tab(4) << "_archive = state.current.load();\n"
+           << tab(4) << "// If reload() moved to the next epoch meanwhile, the archive taken may already be retired\n"
+           << tab(4) << "if (state.epoch.load() == epoch)\n"
+           << tab(4) << "{\n"
+           << tab(5) << "if (_archive != nullptr)\n"
+           << tab(6) << "_archive->snapshots.fetch_add(1u);\n"
+           << tab(5) << "readers.fetch_sub(1u);\n"
+           << tab(5) << "break;\n"
+           << tab(4) << "}\n"
+           << tab(4) << "readers.fetch_sub(1u);\n"
+           << tab(3) << "}\n"
+           << tab(2) << "}\n"
+           << "\n"
+           << tab(2) << "~ArchiveSnapshot()\n"
+           << tab(2) << "{\n"
+           << tab(3) << "auto& state = details::archiveState();\n"
+           << "\n"
+           << tab(3) << "if (_archive == nullptr || _archive->snapshots.fetch_sub(1u) != 1u || _archive == state.current.load())\n"
+           << tab(4) << "return;\n"
+           << "\n"
+           << tab(3) << "// The last snapshot of a retired archive deletes it, unless a reload() is running: the next one will\n"
+           << tab(3) << "if (state.writer.try_lock())\n"
+           << tab(3) << "{\n"
+           << tab(4) << "details::deleteRetiredArchives(state);\n"
+           << tab(4) << "state.writer.unlock();\n"
+           << tab(3) << "}\n"
+           << tab(2) << "}\n"
+           << "\n"
+           << tab(2) << "ArchiveSnapshot(ArchiveSnapshot const&) = delete;\n"
+           << tab(2) << "ArchiveSnapshot& operator=(ArchiveSnapshot const&) = delete;\n"
+           << "\n"
+           << tab(2) << "/// Returns false if no archive was loaded.\n"
+           << tab(2) << "bool valid() const { return _archive != nullptr; }\n"
+           << tab(2) << "/// Number of the call to reload() which loaded the archive, starting at 1.\n"
+           << tab(2) << "std::uint64_t generation() const { return _archive != nullptr ? _archive->generation : 0u; }\n"
+           << tab(2) << "unsigned int size() const { return _archive != nullptr ? _archive->count : 0u; }\n"
+           << tab(2) << "bool contains(std::string_view key) const { return _archive != nullptr && _archive->find(key) != _archive->count; }\n"
+           << "\n"
+           << tab(2) << "/// Returns an empty view if the resource does not exist.\n"
+           << tab(2) << "std::string_view getText(std::string_view key) const\n"
+           << tab(2) << "{\n"
+           << tab(3) << "if (_archive == nullptr)\n"
+           << tab(4) << "return {};\n"
+           << "\n"
+           << tab(3) << "auto const i = _archive->find(key);\n"
+           << "\n"
+           << tab(3) << "return i != _archive->count ? _archive->payload(i) : std::string_view{};\n"
+           << tab(2) << "}\n"
+           << tab(1) << "};\n\n";
+
+    // Print function rescom::reload
+    output << tab() << "/// Map the archive 'path', verify it, then use it instead of the current archive.\n"
+           << tab() << "/// Never waits for the snapshots: the previous archive is unmapped once its last snapshot is destroyed.\n"
+           << tab() << "/// Returns false and keeps the current archive if the file can't be read or is not a valid archive.\n"
+           << tab() << "inline bool reload(char const* path)\n"
+           << tab() << "{\n"
+           << tab(2) << "RESCOM_PROBE(probeReloadStart(path));\n"
+           << "\n"
+           << tab(2) << "auto archive = details::mapArchive(path);\n"
+           << "\n"
+           << tab(2) << "if (archive == nullptr)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "RESCOM_PROBE(probeReloadDone(path, 0u, 0));\n"
+           << tab(3) << "return false;\n"
+           << tab(2) << "}\n"
+           << "\n"
+           << tab(2) << "auto& state = details::archiveState();\n"
+           << tab(2) << "std::lock_guard<std::mutex> lock{state.writer};\n"
+           << "\n"
+           << tab(2) << "archive->generation = ++state.generation;\n"
+           << "\n"
+           << tab(2) << "auto* previous = state.current.exchange(archive.release());\n"
+           << "\n"
+           << tab(2) << "state.epoch.fetch_add(1u);\n"
+           << tab(2) << "if (previous != nullptr)\n"
+           << tab(3) << "state.retired.push_back(previous);\n"
+           << tab(2) << "details::deleteRetiredArchives(state);\n"
+           << "\n"
+           << tab(2) << "RESCOM_PROBE(probeReloadDone(path, state.current.load()->size, 1));\n"
+           << tab(2) << "return true;\n"
+           << tab() << "}\n";
+}
+
+/// Write the code mapping the overlay at startup and the function details::overlaid, used by rescom::getResource.
+/// 'replaced' has a bit per resource of ResourcesIndex, so a resource not replaced costs a single bit test.
+/// The overlay is never unmapped, the resources it replaces stay valid until the end of the program.
+void LegacyCppCodeGenerator::writeOverlayFunctions(std::ostream& output) const
+{
+    std::vector<std::string> sideTables;
+
+    if (hasLineIndex())
+        sideTables.emplace_back("LineIndexes");
+    if (hasTable())
+        sideTables.emplace_back("Tables");
+    if (hasJson())
+        sideTables.emplace_back("JsonDocuments");
+    if (hasDictionary(DictionaryType::Map))
+        sideTables.emplace_back("Maps");
+    if (hasDictionary(DictionaryType::Set))
+        sideTables.emplace_back("Sets");
+    if (hasCompression())
+        sideTables.emplace_back("CompressedResources");
+
+    writeArchiveMapping(output);
+
+    output << "\n"
+           << tab(1) << "namespace details {\n"
+           << tab(2) << format("static constexpr char const* const OverlayPath = {};\n\n", toCppStringLiteral(*_configuration.overlayPath));
+
+    // Only the resources stored as is can be replaced, the others are decoded using their side tables
+    if (sideTables.empty())
+    {
+        output << tab(2) << "inline constexpr bool isStoredAsIs(std::size_t) { return true; }\n\n";
+    }
+    else
+    {
+        output << tab(2) << "inline constexpr bool isStoredAsIs(std::size_t index)\n"
+               << tab(2) << "{\n"
+               << tab(3) << "return ";
+        for (auto i = 0u; i < sideTables.size(); ++i)
+            output << (i > 0u ? " && " : "") << sideTables[i] << "[index] == nullptr";
+        output << ";\n"
+               << tab(2) << "}\n\n";
+    }
+
+    output << tab(2) << "struct Overlay\n"
+           << tab(2) << "{\n"
+           << tab(3) << "std::unique_ptr<MappedArchive> archive;\n"
+           << tab(3) << "std::uint64_t replaced[(ResourcesCount + 63u) / 64u]{};\n"
+           << tab(3) << "/// Positions in ResourcesIndex of the resources replaced, in order\n"
+           << tab(3) << "std::vector<std::size_t> indexes;\n"
+           << tab(3) << "std::vector<Resource> resources;\n"
+           << tab(2) << "};\n\n";
+
+    // Print function details::loadOverlay, the keys not embedded are ignored
+    output << tab(2) << "inline Overlay* loadOverlay(char const* path)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "auto* overlay = new Overlay{mapArchive(path), {}, {}, {}};\n"
+           << "\n"
+           << tab(3) << "if (overlay->archive == nullptr)\n"
+           << tab(4) << "return overlay;\n"
+           << "\n"
+           << tab(3) << "// The keys of the archive are ordered like ResourcesIndex, so the indexes are ordered too.\n"
+           << tab(3) << "// The overlay may have been written for another list of resources, its keys are compared entirely.\n"
+           << tab(3) << "for (std::uint32_t i = 0u; i < overlay->archive->count; ++i)\n"
+           << tab(3) << "{\n"
+           << tab(4) << "auto const it = lowerBound(std::begin(ResourcesIndex), std::end(ResourcesIndex), overlay->archive->key(i).data(), compareSlot);\n"
+           << tab(4) << "auto const index = static_cast<std::size_t>(it - std::begin(ResourcesIndex));\n"
+           << tab(4) << "auto const payload = overlay->archive->payload(i);\n"
+           << "\n"
+           << tab(4) << "if (it == std::end(ResourcesIndex) || std::string_view{it->key} != overlay->archive->key(i) || !isStoredAsIs(index))\n"
+           << tab(5) << "continue;\n"
+           << "\n"
+           << tab(4) << "overlay->replaced[index / 64u] |= std::uint64_t{1u} << (index % 64u);\n"
+           << tab(4) << "overlay->indexes.push_back(index);\n"
+           << tab(4) << "overlay->resources.emplace_back(it->key, static_cast<unsigned int>(payload.size()), payload.data());\n"
+           << tab(3) << "}\n"
+           << "\n"
+           << tab(3) << "return overlay;\n"
+           << tab(2) << "}\n\n";
+
+    // The overlay is mapped during the initialization of the program, or by the first lookup done before
+    output << tab(2) << "inline Overlay const& overlay()\n"
+           << tab(2) << "{\n"
+           << tab(3) << "static Overlay const* const instance = loadOverlay(OverlayPath);\n"
+           << "\n"
+           << tab(3) << "return *instance;\n"
+           << tab(2) << "}\n\n"
+           << tab(2) << "inline Overlay const& OverlayAtStartup = overlay();\n\n";
+
+    output << tab(2) << "inline Resource const& findOverlaid(Resource const& resource)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "auto const& state = overlay();\n"
+           << tab(3) << "auto const index = static_cast<std::size_t>(&resource - std::begin(ResourcesIndex));\n"
+           << "\n"
+           << tab(3) << "if (((state.replaced[index / 64u] >> (index % 64u)) & 1u) == 0u)\n"
+           << tab(4) << "return resource;\n"
+           << "\n"
+           << tab(3) << "return state.resources[static_cast<std::size_t>(std::lower_bound(state.indexes.begin(), state.indexes.end(), index) - state.indexes.begin())];\n"
+           << tab(2) << "}\n\n"
+           << tab(2) << "/// Returns the resource of the overlay replacing 'resource', if any.\n"
+           << tab(2) << "/// Evaluated at compile time, the embedded resource is returned.\n"
+           << tab(2) << "/// Without RESCOM_IS_CONSTANT_EVALUATED, the resources found can't be evaluated at compile time.\n"
+           << "#if defined(RESCOM_IS_CONSTANT_EVALUATED)\n"
+           << tab(2) << "inline constexpr Resource const& overlaid(Resource const& resource)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "if (RESCOM_IS_CONSTANT_EVALUATED() || &resource == &NullResource)\n"
+           << "#else\n"
+           << tab(2) << "inline Resource const& overlaid(Resource const& resource)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "if (&resource == &NullResource)\n"
+           << "#endif\n"
+           << tab(4) << "return resource;\n"
+           << "\n"
+           << tab(3) << "return findOverlaid(resource);\n"
+           << tab(2) << "}\n\n"
+           << tab(2) << "/// Returns the position in ResourcesIndex of a resource, embedded or replaced.\n"
+           << tab(2) << "inline std::size_t indexOf(Resource const& resource)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "auto const& resources = overlay().resources;\n"
+           << "\n"
+           << tab(3) << "if (!resources.empty() && &resource >= resources.data() && &resource < resources.data() + resources.size())\n"
+           << tab(4) << "return overlay().indexes[static_cast<std::size_t>(&resource - resources.data())];\n"
+           << "\n"
+           << tab(3) << "return static_cast<std::size_t>(&resource - std::begin(ResourcesIndex));\n"
+           << tab(2) << "}\n"
+           << tab(1) << "} // namespace details\n\n";
+
+    // Print function rescom::isOverlaid
+    output << tab() << "/// Returns true if the resource is replaced by the overlay.\n"
+           << tab() << "inline bool isOverlaid(char const* key)\n"
+           << tab() << "{\n"
+           << tab(2) << "auto const it = details::lowerBound(std::begin(details::ResourcesIndex), std::end(details::ResourcesIndex), key, details::compareSlot);\n"
+           << "\n"
+           << tab(2) << "return it != std::end(details::ResourcesIndex) && &details::findOverlaid(*it) != it;\n"
+           << tab() << "}\n\n";
+}
+
+std::string makeLineIndexName(unsigned int i, std::string const& suffix)
+{
+    return format("R{}Lines{}", i, suffix);
+}
+
+void LegacyCppCodeGenerator::writeLineIndex(unsigned int inputPosition, std::vector<char> const& buffer, std::ostream& output) const
+{
+    static char const* const DeltaTypes[] = {"unsigned char", "unsigned short", nullptr, "unsigned int"};
+    auto const index = buildLineIndex(buffer);
+
+    output << tab(2) << format("static constexpr unsigned int const {}[] = {", makeLineIndexName(inputPosition, "Checkpoints"));
+    writeArray(output, index.checkpoints);
+    output << "};\n";
+    output << tab(2) << format("static constexpr {} const {}[] = {", DeltaTypes[index.deltaWidth - 1u], makeLineIndexName(inputPosition, "Deltas"));
+    writeArray(output, index.deltas);
+    output << "};\n";
+    output << tab(2) << format("static constexpr LineIndex const {}{ {}, {}, {}, {}, {} };\n",
+                               makeLineIndexName(inputPosition, ""),
+                               index.count,
+                               makeLineIndexName(inputPosition, "Checkpoints"),
+                               index.deltaWidth == 1u ? makeLineIndexName(inputPosition, "Deltas") : "nullptr",
+                               index.deltaWidth == 2u ? makeLineIndexName(inputPosition, "Deltas") : "nullptr",
+                               index.deltaWidth == 4u ? makeLineIndexName(inputPosition, "Deltas") : "nullptr");
+}
+
+/// Write the functions rescom::lineCount, rescom::line and rescom::lines.
+/// Those functions use the line indexes generated for the resources declared with the option 'lines'.
+void LegacyCppCodeGenerator::writeLineAccessFunctions(std::ostream& output) const
+{
+    output << "\n"
+           << tab(1) << "namespace details {\n"
+           << tab(2) << "inline constexpr std::string_view getLine(Resource const& resource, LineIndex const& index, unsigned int line)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "auto const begin = index.offset(line);\n"
+           << tab(3) << "auto size = index.offset(line + 1u) - 1u - begin;\n"
+           << "\n"
+           << tab(3) << "if (size > 0u && resource.bytes[begin + size - 1u] == '\\r') --size;\n"
+           << "\n"
+           << tab(3) << "return std::string_view{resource.bytes + begin, size};\n"
+           << tab(2) << "}\n"
+           << tab(1) << "} // namespace details\n\n";
+
+    // Print class rescom::LineIterator
+    output << tab(1) << "class LineIterator\n"
+           << tab(1) << "{\n"
+           << tab(2) << "Resource const* _resource;\n"
+           << tab(2) << "LineIndex const* _index;\n"
+           << tab(2) << "unsigned int _line;\n"
+           << tab(1) << "public:\n"
+           << tab(2) << "using iterator_category = std::forward_iterator_tag;\n"
+           << tab(2) << "using value_type = std::string_view;\n"
+           << tab(2) << "using difference_type = std::ptrdiff_t;\n"
+           << tab(2) << "using pointer = std::string_view const*;\n"
+           << tab(2) << "using reference = std::string_view;\n"
+           << "\n"
+           << tab(2) << "constexpr LineIterator(Resource const* resource, LineIndex const* index, unsigned int line)\n"
+           << tab(2) << ": _resource(resource), _index(index), _line(line) {}\n"
+           << "\n"
+           << tab(2) << "constexpr std::string_view operator*() const { return details::getLine(*_resource, *_index, _line); }\n"
+           << tab(2) << "constexpr LineIterator& operator++() { ++_line; return *this; }\n"
+           << tab(2) << "constexpr LineIterator operator++(int) { auto previous = *this; ++_line; return previous; }\n"
+           << tab(2) << "constexpr bool operator==(LineIterator const& other) const { return _line == other._line && _index == other._index; }\n"
+           << tab(2) << "constexpr bool operator!=(LineIterator const& other) const { return !(*this == other); }\n"
+           << tab(1) << "};\n\n";
+
+    // Print class rescom::Lines
+    output << tab(1) << "class Lines\n"
+           << tab(1) << "{\n"
+           << tab(2) << "Resource const* _resource;\n"
+           << tab(2) << "LineIndex const* _index;\n"
+           << tab(1) << "public:\n"
+           << tab(2) << "constexpr Lines(Resource const* resource, LineIndex const* index) : _resource(resource), _index(index) {}\n"
+           << "\n"
+           << tab(2) << "constexpr unsigned int size() const { return _index != nullptr ? _index->count : 0u; }\n"
+           << tab(2) << "constexpr bool empty() const { return size() == 0u; }\n"
+           << tab(2) << "constexpr std::string_view operator[](unsigned int line) const { return details::getLine(*_resource, *_index, line); }\n"
+           << tab(2) << "constexpr LineIterator begin() const { return LineIterator{_resource, _index, 0u}; }\n"
+           << tab(2) << "constexpr LineIterator end() const { return LineIterator{_resource, _index, size()}; }\n"
+           << tab(1) << "};\n\n";
+
+    // Print function rescom::lines
+    output << tab() << "inline constexpr Lines lines(char const* key)\n"
+           << tab() << "{\n"
+           << tab(2) << "auto const& resource = getResource(key);\n"
+           << "\n"
+           << tab(2) << "return Lines{&resource, details::getSideTable(details::LineIndexes, resource)};\n"
+           << tab() << "}\n";
+
+    // Print function rescom::lineCount
+    output << "\n"
+           << tab() << "inline constexpr unsigned int lineCount(char const* key)\n"
+           << tab() << "{\n"
+           << tab(2) << "return lines(key).size();\n"
+           << tab() << "}\n";
+
+    // Print function rescom::line, returns an empty view if the line does not exist
+    output << "\n"
+           << tab() << "inline constexpr std::string_view line(char const* key, unsigned int line)\n"
+           << tab() << "{\n"
+           << tab(2) << "auto const resourceLines = lines(key);\n"
+           << "\n"
+           << tab(2) << "if (line >= resourceLines.size())\n"
+           << tab(3) << "return {};\n"
+           << "\n"
+           << tab(2) << "return resourceLines[line];\n"
+           << tab() << "}\n";
+}
+
+/// Write a side table, an array of pointers ordered like ResourcesIndex.
+/// The pointer is null for each resource not matching 'predicate', otherwise it's the expression returned by 'makeName'.
+void LegacyCppCodeGenerator::writeSideTable(std::string const& type, std::string const& name,
+                                            std::function<bool(Input const&)> const& predicate,
+                                            std::function<std::string(unsigned int)> const& makeName,
+                                            std::ostream& output) const
+{
+    output << tab(2) << "static constexpr " << type << " const* const " << name << "[ResourcesCount] = \n";
+    output << tab(2) << "{\n";
+
+    for (auto i = 0u; i < _configuration.inputs.size(); ++i)
+        output << tab(3) << (predicate(_configuration.inputs[i]) ? makeName(i) : std::string("nullptr")) << ",\n";
+
+    output << tab(2) << "};\n";
+}
+
+std::string makeTableName(unsigned int i)
+{
+    return format("R{}Table", i);
+}
+
+std::string makeColumnName(unsigned int i, unsigned int column)
+{
+    return format("R{}Column{}", i, column);
+}
+
+void LegacyCppCodeGenerator::writeTable(Input const& input, unsigned int inputPosition, std::vector<char> const& buffer, std::ostream& output) const
+{
+    auto const columns = compileInput(input, buffer, [&input](std::vector<char> const& text){ return parseCsvTable(text, input.columnTypes, input.tableHeader); });
+
+    for (auto column = 0u; column < columns.size(); ++column)
+    {
+        auto const& values = columns[column].values;
+
+        if (values.empty())
+            continue;
+
+        output << tab(2) << format("alignas(TableAlignment) static constexpr {} const {}[] = {", toCppType(columns[column].type), makeColumnName(inputPosition, column));
+        for (auto i = 0u; i < values.size(); ++i) {
+            if (i > 0u)
+                output << ", ";
+            output << values[i];
+        }
+        output << "};\n";
+    }
+
+    output << tab(2) << format("static constexpr TableColumn const R{}Columns[] = {\n", inputPosition);
+    for (auto column = 0u; column < columns.size(); ++column)
+    {
+        auto const& values = columns[column].values;
+        auto const data = values.empty() ? format("static_cast<{} const*>(nullptr)", toCppType(columns[column].type)) : makeColumnName(inputPosition, column);
+
+        output << tab(3) << "{" << toCppStringLiteral(columns[column].name) << ", ColumnType::" << toTypeName(columns[column].type) << ", "
+               << values.size() << "u, " << data << "},\n";
+    }
+    output << tab(2) << "};\n";
+    output << tab(2) << format("static constexpr Table const {}{ {}u, R{}Columns };\n", makeTableName(inputPosition), columns.size(), inputPosition);
+}
+
+/// Write the functions rescom::table and rescom::columnCount.
+/// Those functions use the typed arrays generated for the resources declared with the option 'csv'.
+void LegacyCppCodeGenerator::writeTableAccessFunctions(std::ostream& output) const
+{
+    // Print function rescom::columnCount
+    output << "\n"
+           << tab() << "inline constexpr unsigned int columnCount(char const* key)\n"
+           << tab() << "{\n"
+           << tab(2) << "auto const* resourceTable = details::getSideTable(details::Tables, getResource(key));\n"
+           << "\n"
+           << tab(2) << "return resourceTable != nullptr ? resourceTable->columnCount : 0u;\n"
+           << tab() << "}\n";
+
+    // Print function rescom::table, returns an empty column if the column does not exist or if T is not the type of the column
+    output << "\n"
+           << tab() << "template <typename T>\n"
+           << tab() << "inline constexpr Column<T> table(char const* key, unsigned int column)\n"
+           << tab() << "{\n"
+           << tab(2) << "auto const* resourceTable = details::getSideTable(details::Tables, getResource(key));\n"
+           << "\n"
+           << tab(2) << "if (resourceTable == nullptr || column >= resourceTable->columnCount || resourceTable->columns[column].type != details::ColumnTraits<T>::Type)\n"
+           << tab(3) << "return {nullptr, 0u};\n"
+           << "\n"
+           << tab(2) << "return {details::ColumnTraits<T>::get(resourceTable->columns[column].data), resourceTable->columns[column].size};\n"
+           << tab() << "}\n";
+
+    output << "\n"
+           << tab() << "template <typename T>\n"
+           << tab() << "inline constexpr Column<T> table(char const* key, std::string_view column)\n"
+           << tab() << "{\n"
+           << tab(2) << "auto const* resourceTable = details::getSideTable(details::Tables, getResource(key));\n"
+           << "\n"
+           << tab(2) << "for (auto i = 0u; resourceTable != nullptr && i < resourceTable->columnCount; ++i)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "if (column == resourceTable->columns[i].name)\n"
+           << tab(4) << "return table<T>(key, i);\n"
+           << tab(2) << "}\n"
+           << "\n"
+           << tab(2) << "return {nullptr, 0u};\n"
+           << tab() << "}\n";
+}
+
+/// Write the struct rescom::Image and the function rescom::image.
+/// The header and the rows are produced by encodeImage(), see Image.hpp.
+void LegacyCppCodeGenerator::writeImageAccessFunctions(std::ostream& output) const
+{
+    output << "\n"
+           << tab(1) << "enum class PixelFormat : unsigned char\n"
+           << tab(1) << "{\n"
+           << tab(2) << "R8 = " << static_cast<unsigned int>(PixelFormat::R8) << "u,\n"
+           << tab(2) << "Rgba8 = " << static_cast<unsigned int>(PixelFormat::Rgba8) << "u,\n"
+           << tab(1) << "};\n\n";
+
+    // Print struct rescom::Image, the rows are 'stride' bytes apart
+    output << tab(1) << "struct Image\n"
+           << tab(1) << "{\n"
+           << tab(2) << "unsigned int width;\n"
+           << tab(2) << "unsigned int height;\n"
+           << tab(2) << "unsigned int stride;\n"
+           << tab(2) << "PixelFormat format;\n"
+           << tab(2) << "unsigned char const* pixels;\n"
+           << "\n"
+           << tab(2) << "constexpr bool valid() const { return pixels != nullptr; }\n"
+           << tab(2) << "constexpr unsigned char const* row(unsigned int y) const { return pixels + std::size_t{y} * stride; }\n"
+           << tab(1) << "};\n\n";
+
+    output << tab(1) << "namespace details {\n"
+           << tab(2) << "inline constexpr unsigned int readImageInteger(char const* bytes, unsigned int size)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "unsigned int value = 0u;\n"
+           << tab(3) << "for (auto i = size; i > 0u; --i)\n"
+           << tab(4) << "value = (value << 8u) | static_cast<unsigned char>(bytes[i - 1u]);\n"
+           << tab(3) << "return value;\n"
+           << tab(2) << "}\n"
+           << tab(1) << "} // namespace details\n\n";
+
+    // Print function rescom::image, the pixels are read in place
+    output << tab() << "inline Image image(char const* key)\n"
+           << tab() << "{\n"
+           << tab(2) << "auto const& resource = getResource(key);\n"
+           << tab(2) << "Image const invalid{0u, 0u, 0u, PixelFormat::Rgba8, nullptr};\n"
+           << "\n"
+           << tab(2) << format("if (resource.size < {}u || std::string_view{resource.bytes, 4u} != \"{}\")\n", ImageHeaderSize, ImageMagic)
+           << tab(3) << "return invalid;\n"
+           << "\n"
+           << tab(2) << "auto const width = details::readImageInteger(resource.bytes + 4u, 4u);\n"
+           << tab(2) << "auto const height = details::readImageInteger(resource.bytes + 8u, 4u);\n"
+           << tab(2) << "auto const pixelSize = details::readImageInteger(resource.bytes + 12u, 2u);\n"
+           << tab(2) << "auto const alignment = details::readImageInteger(resource.bytes + 14u, 2u);\n"
+           << "\n"
+           << tab(2) << "if ((pixelSize != 1u && pixelSize != 4u) || alignment == 0u)\n"
+           << tab(3) << "return invalid;\n"
+           << "\n"
+           << tab(2) << "auto const stride = (std::size_t{width} * pixelSize + alignment - 1u) / alignment * alignment;\n"
+           << tab(2) << format("auto const pixelsOffset = alignment > {}u ? std::size_t{alignment} : {}u;\n", ImageHeaderSize, ImageHeaderSize)
+           << "\n"
+           << tab(2) << "if (pixelsOffset > resource.size || (height != 0u && stride > (resource.size - pixelsOffset) / height))\n"
+           << tab(3) << "return invalid;\n"
+           << "\n"
+           << tab(2) << "return Image{width, height, static_cast<unsigned int>(stride), static_cast<PixelFormat>(pixelSize),\n"
+           << tab(2) << "             reinterpret_cast<unsigned char const*>(resource.bytes) + pixelsOffset};\n"
+           << tab() << "}\n";
+}
+
+/// Write the class rescom::JsonValue and the function rescom::json.
+/// JsonValue reads the binary representation of the JSON documents produced by compileJson(), see Json.hpp.
+void LegacyCppCodeGenerator::writeJsonAccessFunctions(std::ostream& output) const
+{
+    output << "\n"
+           << tab(1) << "enum class JsonType\n"
+           << tab(1) << "{\n"
+           << tab(2) << "Undefined,\n"
+           << tab(2) << "Null,\n"
+           << tab(2) << "Boolean,\n"
+           << tab(2) << "Integer,\n"
+           << tab(2) << "Number,\n"
+           << tab(2) << "String,\n"
+           << tab(2) << "Array,\n"
+           << tab(2) << "Object,\n"
+           << tab(1) << "};\n\n";
+
+    // Print class rescom::JsonValue
+    output << tab(1) << "class JsonValue\n"
+           << tab(1) << "{\n"
+           << tab(2) << "char const* _document = nullptr;\n"
+           << tab(2) << "unsigned int _offset = 0u;\n"
+           << "\n"
+           << tab(2) << "constexpr std::uint64_t read(unsigned int offset, unsigned int size) const\n"
+           << tab(2) << "{\n"
+           << tab(3) << "std::uint64_t value = 0u;\n"
+           << tab(3) << "for (auto i = 0u; i < size; ++i)\n"
+           << tab(4) << "value |= static_cast<std::uint64_t>(static_cast<unsigned char>(_document[offset + i])) << (i * 8u);\n"
+           << tab(3) << "return value;\n"
+           << tab(2) << "}\n"
+           << tab(2) << "constexpr unsigned int readOffset(unsigned int offset) const { return static_cast<unsigned int>(read(offset, 4u)); }\n"
+           << tab(2) << "constexpr char tag() const { return _document != nullptr ? _document[_offset] : '\\0'; }\n"
+           << tab(2) << "constexpr JsonValue at(unsigned int offset) const { return JsonValue{_document, readOffset(offset)}; }\n"
+           << tab(1) << "public:\n"
+           << tab(2) << "constexpr JsonValue() = default;\n"
+           << tab(2) << "constexpr JsonValue(char const* document, unsigned int offset) : _document(document), _offset(offset) {}\n"
+           << "\n"
+           << tab(2) << "/// Returns the root value of a document.\n"
+           << tab(2) << "static constexpr JsonValue root(char const* document) { return JsonValue{document, 0u}.at(0u); }\n"
+           << "\n"
+           << tab(2) << "constexpr JsonType type() const\n"
+           << tab(2) << "{\n"
+           << tab(3) << "switch (tag())\n"
+           << tab(3) << "{\n"
+           << tab(4) << "case '" << JsonTape::Null << "': return JsonType::Null;\n"
+           << tab(4) << "case '" << JsonTape::True << "': case '" << JsonTape::False << "': return JsonType::Boolean;\n"
+           << tab(4) << "case '" << JsonTape::Integer << "': return JsonType::Integer;\n"
+           << tab(4) << "case '" << JsonTape::Number << "': return JsonType::Number;\n"
+           << tab(4) << "case '" << JsonTape::String << "': return JsonType::String;\n"
+           << tab(4) << "case '" << JsonTape::Array << "': return JsonType::Array;\n"
+           << tab(4) << "case '" << JsonTape::Object << "': return JsonType::Object;\n"
+           << tab(4) << "default: return JsonType::Undefined;\n"
+           << tab(3) << "}\n"
+           << tab(2) << "}\n"
+           << "\n"
+           << tab(2) << "constexpr bool exists() const { return _document != nullptr; }\n"
+           << tab(2) << "constexpr bool isNull() const { return tag() == '" << JsonTape::Null << "'; }\n"
+           << "\n"
+           << tab(2) << "constexpr bool asBool(bool fallback = false) const\n"
+           << tab(2) << "{\n"
+           << tab(3) << "return tag() == '" << JsonTape::True << "' ? true : tag() == '" << JsonTape::False << "' ? false : fallback;\n"
+           << tab(2) << "}\n"
+           << "\n"
+           << tab(2) << "constexpr std::int64_t asInteger(std::int64_t fallback = 0) const\n"
+           << tab(2) << "{\n"
+           << tab(3) << "return tag() == '" << JsonTape::Integer << "' ? static_cast<std::int64_t>(read(_offset + 1u, 8u)) : fallback;\n"
+           << tab(2) << "}\n"
+           << "\n"
+           << tab(2) << "double asNumber(double fallback = 0.) const\n"
+           << tab(2) << "{\n"
+           << tab(3) << "if (tag() == '" << JsonTape::Integer << "')\n"
+           << tab(4) << "return static_cast<double>(asInteger());\n"
+           << tab(3) << "if (tag() != '" << JsonTape::Number << "')\n"
+           << tab(4) << "return fallback;\n"
+           << "\n"
+           << tab(3) << "std::uint64_t const bits = read(_offset + 1u, 8u);\n"
+           << tab(3) << "double value = 0.;\n"
+           << tab(3) << "std::memcpy(&value, &bits, sizeof(value));\n"
+           << tab(3) << "return value;\n"
+           << tab(2) << "}\n"
+           << "\n"
+           << tab(2) << "/// The view returned is null terminated.\n"
+           << tab(2) << "constexpr std::string_view asString(std::string_view fallback = {}) const\n"
+           << tab(2) << "{\n"
+           << tab(3) << "return tag() == '" << JsonTape::String << "' ? std::string_view{_document + _offset + 5u, readOffset(_offset + 1u)} : fallback;\n"
+           << tab(2) << "}\n"
+           << "\n"
+           << tab(2) << "/// Returns the count of elements of an array or the count of members of an object.\n"
+           << tab(2) << "constexpr unsigned int size() const\n"
+           << tab(2) << "{\n"
+           << tab(3) << "return tag() == '" << JsonTape::Array << "' || tag() == '" << JsonTape::Object << "' ? readOffset(_offset + 1u) : 0u;\n"
+           << tab(2) << "}\n"
+           << "\n"
+           << tab(2) << "/// Returns the element of an array or the value of a member of an object.\n"
+           << tab(2) << "constexpr JsonValue operator[](unsigned int index) const\n"
+           << tab(2) << "{\n"
+           << tab(3) << "if (index >= size()) return {};\n"
+           << tab(3) << "return tag() == '" << JsonTape::Array << "' ? at(_offset + 5u + index * 4u) : at(_offset + 9u + index * 8u);\n"
+           << tab(2) << "}\n"
+           << "\n"
+           << tab(2) << "/// Returns the key of a member of an object. Members are ordered by key.\n"
+           << tab(2) << "constexpr std::string_view keyAt(unsigned int index) const\n"
+           << tab(2) << "{\n"
+           << tab(3) << "if (tag() != '" << JsonTape::Object << "' || index >= size()) return {};\n"
+           << tab(3) << "return at(_offset + 5u + index * 8u).asString();\n"
+           << tab(2) << "}\n"
+           << "\n"
+           << tab(2) << "constexpr JsonValue operator[](std::string_view key) const\n"
+           << tab(2) << "{\n"
+           << tab(3) << "if (tag() != '" << JsonTape::Object << "') return {};\n"
+           << "\n"
+           << tab(3) << "unsigned int first = 0u;\n"
+           << tab(3) << "unsigned int count = size();\n"
+           << tab(3) << "while (count > 0u) {\n"
+           << tab(4) << "auto const step = count / 2u;\n"
+           << tab(4) << "if (keyAt(first + step) < key) { first += step + 1u; count -= step + 1u; } else { count = step; }\n"
+           << tab(3) << "}\n"
+           << tab(3) << "return first < size() && keyAt(first) == key ? (*this)[first] : JsonValue{};\n"
+           << tab(2) << "}\n"
+           << "\n"
+           << tab(2) << "constexpr bool contains(std::string_view key) const { return (*this)[key].exists(); }\n"
+           << tab(1) << "};\n\n";
+
+    // Print function rescom::json, returns an undefined value if the resource is not a JSON document
+    output << tab() << "inline constexpr JsonValue json(char const* key)\n"
+           << tab() << "{\n"
+           << tab(2) << "auto const* document = details::getSideTable(details::JsonDocuments, getResource(key));\n"
+           << "\n"
+           << tab(2) << "if (document == nullptr)\n"
+           << tab(3) << "return {};\n"
+           << "\n"
+           << tab(2) << "return JsonValue::root(document);\n"
+           << tab() << "}\n";
+}
+
+/// Write the types used to store dictionaries in perfect hash tables.
+/// The function details::hashKey must stay identical to the function hashKey() used to build the tables.
+void LegacyCppCodeGenerator::writeDictionaryTypes(std::ostream& output) const
+{
+    output << tab(1) << "struct DictionaryEntry\n"
+           << tab(1) << "{\n"
+           << tab(2) << "std::string_view const key;\n"
+           << tab(2) << "std::string_view const value;\n"
+           << tab(1) << "};\n\n";
+
+    output << tab(1) << "namespace details {\n"
+           << tab(2) << "struct Dictionary\n"
+           << tab(2) << "{\n"
+           << tab(3) << "unsigned int const size;\n"
+           << tab(3) << "unsigned int const bucketCount;\n"
+           << tab(3) << "unsigned int const slotCount;\n"
+           << tab(3) << "std::uint32_t const* const seeds;\n"
+           << tab(3) << "DictionaryEntry const* const slots;\n"
+           << tab(2) << "};\n\n"
+           << tab(2) << "constexpr std::uint32_t hashKey(std::string_view key, std::uint32_t seed)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "std::uint32_t hash = 2166136261u ^ seed;\n"
+           << tab(3) << "for (auto const c : key) { hash ^= static_cast<unsigned char>(c); hash *= 16777619u; }\n"
+           << tab(3) << "hash ^= hash >> 16u; hash *= 0x85ebca6bu; hash ^= hash >> 13u; hash *= 0xc2b2ae35u; hash ^= hash >> 16u;\n"
+           << tab(3) << "return hash;\n"
+           << tab(2) << "}\n\n"
+           << tab(2) << "constexpr DictionaryEntry const* findEntry(Dictionary const* dictionary, std::string_view key)\n"
+           << tab(2) << "{\n"
+           << tab(3) << "if (dictionary == nullptr) return nullptr;\n"
+           << "\n"
+           << tab(3) << "auto const seed = dictionary->seeds[hashKey(key, 0u) % dictionary->bucketCount];\n"
+           << tab(3) << "auto const& entry = dictionary->slots[hashKey(key, seed) % dictionary->slotCount];\n"
+           << "\n"
+           << tab(3) << "return entry.key.data() != nullptr && entry.key == key ? &entry : nullptr;\n"
+           << tab(2) << "}\n"
+           << tab(1) << "} // namespace details\n\n";
+}
+
+std::string makeDictionaryName(unsigned int i)
+{
+    return format("R{}Dictionary", i);
+}
+
+void LegacyCppCodeGenerator::writeDictionary(Input const& input, unsigned int inputPosition, std::vector<char> const& buffer, std::ostream& output) const
+{
+    auto const entries = compileInput(input, buffer, input.dictionaryType == DictionaryType::Map ? parseKeyValues : parseWords);
+    auto const table = buildPerfectHashTable(entries);
+    auto const makeStringView = [](std::string const& text)
+    {
+        return format("std::string_view{ {}, {}u }", toCppStringLiteral(text), text.size());
+    };
+
+    output << tab(2) << format("static constexpr std::uint32_t const R{}Seeds[] = {", inputPosition);
+    writeArray(output, table.seeds);
+    output << "};\n";
+
+    output << tab(2) << format("static constexpr DictionaryEntry const R{}Slots[] = {\n", inputPosition);
+    for (auto const entryIndex : table.slots)
+    {
+        if (entryIndex < 0)
+        {
+            output << tab(3) << "{},\n";
+            continue;
+        }
+
+        auto const& entry = entries[static_cast<std::size_t>(entryIndex)];
+
+        output << tab(3) << "{" << makeStringView(entry.key) << ", " << makeStringView(entry.value) << "},\n";
+    }
+    output << tab(2) << "};\n";
+
+    output << tab(2) << format("static constexpr Dictionary const {}{ {}u, {}u, {}u, R{}Seeds, R{}Slots };\n",
+                               makeDictionaryName(inputPosition), entries.size(), table.seeds.size(), table.slots.size(),
+                               inputPosition, inputPosition);
+}
+
+/// Write the classes rescom::Map and rescom::Set and the functions rescom::map and rescom::set.
+/// Each lookup computes two hashes and compares one key.
+void LegacyCppCodeGenerator::writeDictionaryAccessFunctions(std::ostream& output) const
+{
+    if (hasDictionary(DictionaryType::Map))
+    {
+        // Print class rescom::Map
+        output << "\n"
+               << tab(1) << "class Map\n"
+               << tab(1) << "{\n"
+               << tab(2) << "details::Dictionary const* _dictionary;\n"
+               << tab(1) << "public:\n"
+               << tab(2) << "constexpr explicit Map(details::Dictionary const* dictionary) : _dictionary(dictionary) {}\n"
+               << "\n"
+               << tab(2) << "constexpr unsigned int size() const { return _dictionary != nullptr ? _dictionary->size : 0u; }\n"
+               << tab(2) << "constexpr bool empty() const { return size() == 0u; }\n"
+               << tab(2) << "/// Returns nullptr if the key does not exist.\n"
+               << tab(2) << "constexpr DictionaryEntry const* find(std::string_view key) const { return details::findEntry(_dictionary, key); }\n"
+               << tab(2) << "constexpr bool contains(std::string_view key) const { return find(key) != nullptr; }\n"
+               << tab(2) << "constexpr std::string_view get(std::string_view key, std::string_view fallback = {}) const\n"
+               << tab(2) << "{\n"
+               << tab(3) << "auto const* entry = find(key);\n"
+               << "\n"
+               << tab(3) << "return entry != nullptr ? entry->value : fallback;\n"
+               << tab(2) << "}\n"
+               << tab(1) << "};\n\n";
+
+        // Print function rescom::map, returns an empty map if the resource is not a map
+        output << tab() << "inline constexpr Map map(char const* key)\n"
+               << tab() << "{\n"
+               << tab(2) << "return Map{details::getSideTable(details::Maps, getResource(key))};\n"
+               << tab() << "}\n";
+    }
+
+    if (hasDictionary(DictionaryType::Set))
+    {
+        // Print class rescom::Set
+        output << "\n"
+               << tab(1) << "class Set\n"
+               << tab(1) << "{\n"
+               << tab(2) << "details::Dictionary const* _dictionary;\n"
+               << tab(1) << "public:\n"
+               << tab(2) << "constexpr explicit Set(details::Dictionary const* dictionary) : _dictionary(dictionary) {}\n"
+               << "\n"
+               << tab(2) << "constexpr unsigned int size() const { return _dictionary != nullptr ? _dictionary->size : 0u; }\n"
+               << tab(2) << "constexpr bool empty() const { return size() == 0u; }\n"
+               << tab(2) << "constexpr bool contains(std::string_view word) const { return details::findEntry(_dictionary, word) != nullptr; }\n"
+               << tab(1) << "};\n\n";
+
+        // Print function rescom::set, returns an empty set if the resource is not a set
+        output << tab() << "inline constexpr Set set(char const* key)\n"
+               << tab() << "{\n"
+               << tab(2) << "return Set{details::getSideTable(details::Sets, getResource(key))};\n"
+               << tab() << "}\n";
+    }
+}
+
+void LegacyCppCodeGenerator::writeResources(std::ostream& output) const
+{
+    if (_configuration.inputs.empty())
+        return;
+
+    std::vector<char> buffer;
+    std::vector<std::size_t> sizes;
+    std::vector<std::optional<std::string>> inlineContents(_configuration.inputs.size());
+
+    buffer.reserve(1024 * 16);
+
+    output << tab(1) << "namespace details {\n";
+    output << tab(2) << "static constexpr unsigned int const ResourcesCount = " << _configuration.inputs.size() << ";\n";
+
+    // Write data
+    for (auto i = 0u; i < _configuration.inputs.size(); ++i)
+    {
+        auto const& input = _configuration.inputs[i];
+
+        loadInputContent(input, buffer);
+
+        if (!input.transforms.empty())
+        {
+            buffer = compileInput(input, buffer, [this, &input](std::vector<char> content)
+            {
+                applyTransforms(input.transforms, content, _configuration.cacheDirectory);
+                return content;
+            });
+        }
+
+        if (input.json)
+            buffer = compileInput(input, buffer, compileJson);
+
+        // A compressed resource stores the compressed frames, the Reader decodes them
+        if (input.frameSize > 0u)
+        {
+            auto frames = compressFrames(buffer, input.frameSize);
+
+            writeCompressedResource(input, i, buffer.size(), frames, output);
+            buffer = std::move(frames.data);
+        }
+
+        // The JSON documents are accessed using their array, the images need the alignment of their array
+        if (_configuration.inlineThreshold > 0u && buffer.size() <= _configuration.inlineThreshold && !input.json && !getImageRowAlignment(input).has_value())
+            inlineContents[i] = std::string(buffer.begin(), buffer.end());
+        else
+            writeResource(input, i, buffer, output);
+        sizes.push_back(buffer.size());
+
+        if (input.lineIndex)
+            writeLineIndex(i, buffer, output);
+
+        if (!input.columnTypes.empty())
+            writeTable(input, i, buffer, output);
+
+        if (input.dictionaryType != DictionaryType::None)
+            writeDictionary(input, i, buffer, output);
+    }
+
+    // Write index
+    output << tab(2) << "static constexpr Resource const ResourcesIndex[ResourcesCount] = \n";
+    output << tab(2) << "{\n";
+
+    for (auto i = 0u; i < _configuration.inputs.size(); ++i)
+    {
+        auto const& input = _configuration.inputs[i];
+        auto resourceName = makeResourceName(i);
+
+        if (inlineContents[i].has_value())
+            output << tab(3) << "{" << toCppStringLiteral(input.key) << ", " << sizes[i] << ", ResourcesIndex[" << i << "].inlineBytes, " << toCppStringLiteral(*inlineContents[i]) << "},\n";
+        else
+            output << tab(3) << "{" << toCppStringLiteral(input.key) << ", " << sizes[i] << ", " << resourceName << "},\n";
+    }
+
+    output << tab(2) << "};\n";
+
+    if (hasLineIndex())
+        writeSideTable("LineIndex", "LineIndexes", [](Input const& input){ return input.lineIndex; }, [](unsigned int i){ return "&" + makeLineIndexName(i, ""); }, output);
+
+    if (hasTable())
+        writeSideTable("Table", "Tables", [](Input const& input){ return !input.columnTypes.empty(); }, [](unsigned int i){ return "&" + makeTableName(i); }, output);
+
+    if (hasJson())
+        writeSideTable("char", "JsonDocuments", [](Input const& input){ return input.json; }, makeResourceName, output);
+
+    if (hasDictionary(DictionaryType::Map))
+        writeSideTable("Dictionary", "Maps", [](Input const& input){ return input.dictionaryType == DictionaryType::Map; }, [](unsigned int i){ return "&" + makeDictionaryName(i); }, output);
+
+    if (hasDictionary(DictionaryType::Set))
+        writeSideTable("Dictionary", "Sets", [](Input const& input){ return input.dictionaryType == DictionaryType::Set; }, [](unsigned int i){ return "&" + makeDictionaryName(i); }, output);
+
+    if (hasCompression())
+        writeSideTable("CompressedResource", "CompressedResources", [](Input const& input){ return input.frameSize > 0u; }, [](unsigned int i){ return "&" + makeCompressedResourceName(i, ""); }, output);
 
-    output << tab(2) << "};\n";
     output << tab(1) << "} // namespace details\n\n";
 }
\ No newline at end of file
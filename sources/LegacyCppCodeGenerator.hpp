@@ -3,8 +3,11 @@
 #include <ostream>
 #include <vector>
 #include <string>
+#include <functional>
 
 #include "CodeGenerator.hpp"
+#include "Dictionary.hpp"
+#include "Compression.hpp"
 
 struct Configuration;
 struct Input;
@@ -24,9 +27,42 @@ private:
 
     void writeFileHeader(std::ostream& output) const;
     void writeFileFooter(std::ostream& output) const;
+    void writeProbes(std::ostream& output) const;
     void writeResource(Input const& input, unsigned int inputPosition, std::vector<char> const& buffer, std::ostream& output) const;
     void writeAccessFunction(std::ostream& output) const;
     void writeResources(std::ostream& output) const;
+    void writeLineIndex(unsigned int inputPosition, std::vector<char> const& buffer, std::ostream& output) const;
+    void writeLineAccessFunctions(std::ostream& output) const;
+    void writeTableTypes(std::ostream& output) const;
+    void writeTable(Input const& input, unsigned int inputPosition, std::vector<char> const& buffer, std::ostream& output) const;
+    void writeTableAccessFunctions(std::ostream& output) const;
+    void writeJsonAccessFunctions(std::ostream& output) const;
+    void writeDictionaryTypes(std::ostream& output) const;
+    void writeDictionary(Input const& input, unsigned int inputPosition, std::vector<char> const& buffer, std::ostream& output) const;
+    void writeDictionaryAccessFunctions(std::ostream& output) const;
+    void writeImageAccessFunctions(std::ostream& output) const;
+    void writeVariantAccessFunctions(std::ostream& output) const;
+    void writeCompressionTypes(std::ostream& output) const;
+    void writeCompressedResource(Input const& input, unsigned int inputPosition, std::size_t size, CompressedFrames const& frames, std::ostream& output) const;
+    void writeReader(std::ostream& output) const;
+    void writeCacheFunctions(std::ostream& output) const;
+    void writeArchiveMapping(std::ostream& output) const;
+    void writeArchiveFunctions(std::ostream& output) const;
+    void writeOverlayFunctions(std::ostream& output) const;
+    void writeSideTable(std::string const& type, std::string const& name,
+                        std::function<bool(Input const&)> const& predicate,
+                        std::function<std::string(unsigned int)> const& makeName,
+                        std::ostream& output) const;
+
+    bool hasLineIndex() const;
+    bool hasTable() const;
+    bool hasJson() const;
+    bool hasDictionary(DictionaryType type) const;
+    bool hasSideTables() const;
+    bool hasVariants() const;
+    bool hasCompression() const;
+    bool hasImages() const;
+    bool hasOverlay() const;
 private:
     Configuration const& _configuration;
     std::string const _tabulation;
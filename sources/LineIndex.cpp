@@ -0,0 +1,55 @@
+#include "LineIndex.hpp"
+
+#include <algorithm>
+#include <limits>
+
+std::uint32_t LineIndex::offset(std::uint32_t line) const
+{
+    return checkpoints[line / CheckpointInterval] + deltas[line];
+}
+
+LineIndex buildLineIndex(std::vector<char> const& buffer)
+{
+    std::vector<std::uint32_t> offsets;
+
+    if (!buffer.empty())
+        offsets.push_back(0u);
+
+    for (auto i = 0u; i < buffer.size(); ++i)
+    {
+        if (buffer[i] == '\n' && i + 1u < buffer.size())
+            offsets.push_back(i + 1u);
+    }
+
+    LineIndex index;
+
+    index.count = static_cast<std::uint32_t>(offsets.size());
+
+    // The end sentinel behave like if the last line was always terminated by a new line.
+    if (!buffer.empty())
+        offsets.push_back(static_cast<std::uint32_t>(buffer.back() == '\n' ? buffer.size() : buffer.size() + 1u));
+    else
+        offsets.push_back(1u);
+
+    std::uint32_t maximumDelta = 0u;
+
+    for (auto line = 0u; line < offsets.size(); ++line)
+    {
+        if (line % LineIndex::CheckpointInterval == 0u)
+            index.checkpoints.push_back(offsets[line]);
+
+        auto const delta = offsets[line] - index.checkpoints.back();
+
+        maximumDelta = std::max(maximumDelta, delta);
+        index.deltas.push_back(delta);
+    }
+
+    if (maximumDelta <= std::numeric_limits<std::uint8_t>::max())
+        index.deltaWidth = 1u;
+    else if (maximumDelta <= std::numeric_limits<std::uint16_t>::max())
+        index.deltaWidth = 2u;
+    else
+        index.deltaWidth = 4u;
+
+    return index;
+}
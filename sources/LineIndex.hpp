@@ -0,0 +1,30 @@
+#ifndef RESCOM_LINEINDEX_HPP
+#define RESCOM_LINEINDEX_HPP
+#include <cstdint>
+#include <vector>
+
+/// \brief Offsets of the lines of a text resource
+/// The offset of the line N is checkpoints[N / CheckpointInterval] + deltas[N].
+/// Deltas are relative to the last checkpoint, this way they can be stored using the smallest
+/// integer type possible while keeping the access to any line O(1).
+/// There is one more offset than lines: the last one is the end sentinel, so the line N always ends
+/// at offset(N + 1) - 1.
+struct LineIndex
+{
+    static constexpr unsigned int const CheckpointInterval = 64u;
+
+    /// Count of lines
+    std::uint32_t count = 0u;
+    /// Absolute offsets of one line every CheckpointInterval lines
+    std::vector<std::uint32_t> checkpoints;
+    /// Offsets relative to the previous checkpoint, one per line plus the end sentinel
+    std::vector<std::uint32_t> deltas;
+    /// Size in bytes required to store each delta: 1, 2 or 4
+    unsigned int deltaWidth = 1u;
+
+    std::uint32_t offset(std::uint32_t line) const;
+};
+
+LineIndex buildLineIndex(std::vector<char> const& buffer);
+
+#endif //RESCOM_LINEINDEX_HPP
@@ -0,0 +1,109 @@
+#include "ResourceSet.hpp"
+#include "Configuration.hpp"
+#include "FileSystem.hpp"
+#include "StringHelpers.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+void loadInputContent(Input const& input, std::vector<char>& buffer)
+{
+    if (input.archiveOffset.has_value())
+        LocalFileSystem{}.getContent(input.filePath, *input.archiveOffset, static_cast<std::size_t>(input.size), buffer);
+    else
+        LocalFileSystem{}.getContent(input.filePath, buffer);
+}
+
+ResourceSet loadResourceSet(Configuration const& configuration)
+{
+    ResourceSet resources;
+
+    for (auto const& input : configuration.inputs)
+        loadInputContent(input, resources[input.key]);
+
+    return resources;
+}
+
+ResourceSet loadTransformedResourceSet(Configuration const& configuration)
+{
+    ResourceSet resources;
+
+    for (auto const& [key, load] : makeTransformedResourceLoaders(configuration))
+        load(resources[key]);
+
+    return resources;
+}
+
+ResourceLoaders makeTransformedResourceLoaders(Configuration const& configuration)
+{
+    ResourceLoaders loaders;
+
+    for (auto const& input : configuration.inputs)
+    {
+        loaders[input.key] = [&input, &configuration](std::vector<char>& buffer)
+        {
+            loadInputContent(input, buffer);
+
+            try
+            {
+                applyTransforms(input.transforms, buffer, configuration.cacheDirectory);
+            }
+            catch (std::runtime_error const& error)
+            {
+                throw std::runtime_error(format("{}: {}", input.filePath.generic_string(), error.what()));
+            }
+        };
+    }
+
+    return loaders;
+}
+
+ResourceLoaders makeResourceLoaders(ResourceSet const& resources)
+{
+    ResourceLoaders loaders;
+
+    for (auto const& [key, content] : resources)
+        loaders[key] = [&content = content](std::vector<char>& buffer){ buffer = content; };
+
+    return loaders;
+}
+
+bool isContainedKey(std::string_view key)
+{
+    // The backslash and the drive letters are checked too, for Windows
+    if (key.empty() || key.front() == '/' || key.front() == '\\' || (key.size() >= 2u && key[1] == ':'))
+        return false;
+
+    for (std::size_t begin = 0u; begin <= key.size();)
+    {
+        auto end = key.find_first_of("/\\", begin);
+
+        if (end == std::string_view::npos)
+            end = key.size();
+
+        if (key.substr(begin, end - begin) == "..")
+            return false;
+
+        begin = end + 1u;
+    }
+
+    return true;
+}
+
+void writeResourceSet(ResourceSet const& resources, std::filesystem::path const& directory)
+{
+    for (auto const& [key, content] : resources)
+    {
+        if (!isContainedKey(key))
+            throw std::runtime_error(format("unable to write '{}', the path is outside of the output directory", key));
+
+        auto const filePath = directory / key;
+
+        std::filesystem::create_directories(filePath.parent_path());
+
+        std::ofstream file{filePath, std::ios::binary | std::ios::trunc};
+
+        if (!file.is_open() || !file.write(content.data(), static_cast<std::streamsize>(content.size())))
+            throw std::runtime_error(format("unable to write '{}'", filePath.generic_string()));
+    }
+}
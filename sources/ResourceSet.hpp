@@ -0,0 +1,44 @@
+#ifndef RESCOM_RESOURCESET_HPP
+#define RESCOM_RESOURCESET_HPP
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct Configuration;
+struct Input;
+
+/// Contents of resources, by key.
+using ResourceSet = std::map<std::string, std::vector<char>>;
+
+/// Functions loading the content of resources into a buffer, by key.
+/// The resources are loaded one at a time by their user, so they are never all in memory together.
+using ResourceLoaders = std::map<std::string, std::function<void(std::vector<char>& buffer)>>;
+
+/// Load the content of the file of an input. Members of tar archives are read directly from the archive.
+void loadInputContent(Input const& input, std::vector<char>& buffer);
+
+/// Load the content of the files of all the inputs of a configuration.
+ResourceSet loadResourceSet(Configuration const& configuration);
+
+/// Load the content of the files of all the inputs of a configuration, then apply their transforms.
+ResourceSet loadTransformedResourceSet(Configuration const& configuration);
+
+/// Returns the functions loading the content of the file of each input of a configuration, then applying its transforms.
+/// The functions refer to 'configuration', it must outlive them.
+ResourceLoaders makeTransformedResourceLoaders(Configuration const& configuration);
+
+/// Returns the functions copying the contents of 'resources'. The functions refer to 'resources'.
+ResourceLoaders makeResourceLoaders(ResourceSet const& resources);
+
+/// Returns true if 'key' is a relative path which stays inside the directory it's written into:
+/// not empty, not absolute, and without the component "..".
+bool isContainedKey(std::string_view key);
+
+/// Write each resource into 'directory', the key being the path of the file.
+/// Throws std::runtime_error if a key is not contained in 'directory', see isContainedKey.
+void writeResourceSet(ResourceSet const& resources, std::filesystem::path const& directory);
+
+#endif //RESCOM_RESOURCESET_HPP
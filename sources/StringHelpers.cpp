@@ -43,3 +43,93 @@ std::string_view removeComment(std::string_view view, char const* oneLineComment
     return view;
 }
 
+std::vector<std::string_view> split(std::string_view view, char separator)
+{
+    std::vector<std::string_view> result;
+
+    for (auto position = view.find(separator); position != std::string_view::npos; position = view.find(separator))
+    {
+        result.push_back(view.substr(0u, position));
+        view.remove_prefix(position + 1u);
+    }
+
+    result.push_back(view);
+
+    return result;
+}
+
+std::string toCppStringLiteral(std::string_view view)
+{
+    std::string result;
+
+    result.reserve(view.size() + 2u);
+    result.push_back('"');
+
+    for (auto const c : view)
+    {
+        auto const byte = static_cast<unsigned char>(c);
+
+        if (c == '"' || c == '\\')
+        {
+            result.push_back('\\');
+            result.push_back(c);
+        }
+        else if (byte < 0x20u || byte >= 0x7fu)
+        {
+            // Octal escape sequences have at most 3 digits, so unlike hexadecimal escape sequences
+            // they can't swallow the following characters.
+            result.push_back('\\');
+            result.push_back(static_cast<char>('0' + ((byte >> 6u) & 0x7u)));
+            result.push_back(static_cast<char>('0' + ((byte >> 3u) & 0x7u)));
+            result.push_back(static_cast<char>('0' + (byte & 0x7u)));
+        }
+        else
+        {
+            result.push_back(c);
+        }
+    }
+
+    result.push_back('"');
+
+    return result;
+}
+
+bool matchGlob(std::string_view pattern, std::string_view text)
+{
+    if (pattern.empty())
+        return text.empty();
+
+    if (pattern.substr(0u, 2u) == "**")
+    {
+        for (auto i = 0u; i <= text.size(); ++i)
+        {
+            if (matchGlob(pattern.substr(2u), text.substr(i)))
+                return true;
+        }
+
+        return false;
+    }
+
+    if (pattern.front() == '*')
+    {
+        for (auto i = 0u; i <= text.size(); ++i)
+        {
+            if (matchGlob(pattern.substr(1u), text.substr(i)))
+                return true;
+
+            if (i < text.size() && text[i] == '/')
+                break;
+        }
+
+        return false;
+    }
+
+    if (text.empty())
+        return false;
+
+    if (pattern.front() == '?' ? text.front() == '/' : pattern.front() != text.front())
+        return false;
+
+    return matchGlob(pattern.substr(1u), text.substr(1u));
+}
+
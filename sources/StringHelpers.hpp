@@ -10,6 +10,12 @@ std::string toUpper(std::string str);
 std::string toLower(std::string str);
 std::string_view trim(std::string_view view);
 std::string_view removeComment(std::string_view view, char const* oneLineCommentStart);
+std::vector<std::string_view> split(std::string_view view, char separator);
+/// Returns true if 'text' matches the glob 'pattern'.
+/// '*' matches any sequence of characters except '/', '**' matches any sequence of characters and '?' matches one character except '/'.
+bool matchGlob(std::string_view pattern, std::string_view text);
+/// Returns a C++ string literal, including the quotes, containing the text 'view'.
+std::string toCppStringLiteral(std::string_view view);
 
 namespace details
 {
@@ -25,8 +31,9 @@ namespace details
             static constexpr bool const IsValueTypeArray = std::is_array_v<CleanedType<T>>;
             static constexpr bool const IsChar = std::is_same_v<std::string::value_type, ValueType>;
             static constexpr bool const IsString = std::is_same_v<std::string, ValueType> || std::is_same_v<std::string_view, ValueType>;
+            static constexpr bool const IsCharPointer = std::is_same_v<char const*, ValueType> || std::is_same_v<char*, ValueType>;
 
-            if constexpr ((IsValueTypeArray && IsChar) || IsString)
+            if constexpr ((IsValueTypeArray && IsChar) || IsString || IsCharPointer)
                 return std::string(value);
             else
                 return std::to_string(value);
@@ -0,0 +1,197 @@
+#include "Tar.hpp"
+#include "ResourceSet.hpp"
+#include "StringHelpers.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+namespace
+{
+    static constexpr std::size_t const BlockSize = 512u;
+
+    struct Field
+    {
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    static constexpr Field const Name{0u, 100u};
+    static constexpr Field const Size{124u, 12u};
+    static constexpr Field const Checksum{148u, 8u};
+    static constexpr Field const TypeFlag{156u, 1u};
+    static constexpr Field const Magic{257u, 5u};
+    static constexpr Field const Prefix{345u, 155u};
+
+    /// Returns the field, without the trailing null characters.
+    std::string_view getField(std::vector<char> const& header, Field field)
+    {
+        std::string_view const view{header.data() + field.offset, field.size};
+
+        return view.substr(0u, std::min(view.find('\0'), view.size()));
+    }
+
+    /// Numbers are written in octal, padded with spaces or null characters.
+    /// GNU tar uses a base-256 encoding for the sizes larger than 8GB, the first byte has its highest bit set.
+    std::uint64_t parseNumber(std::vector<char> const& header, Field field, std::uint64_t headerOffset)
+    {
+        if (static_cast<unsigned char>(header[field.offset]) & 0x80u)
+        {
+            std::uint64_t value = static_cast<unsigned char>(header[field.offset]) & 0x7Fu;
+
+            for (auto i = 1u; i < field.size; ++i)
+                value = (value << 8u) | static_cast<unsigned char>(header[field.offset + i]);
+
+            return value;
+        }
+
+        auto const text = trim(getField(header, field));
+        std::uint64_t value = 0u;
+        auto const [end, error] = std::from_chars(text.data(), text.data() + text.size(), value, 8);
+
+        if (error != std::errc{} || end != text.data() + text.size())
+            throw std::runtime_error(format("invalid number in the header at offset {}", headerOffset));
+
+        return value;
+    }
+
+    bool isZeroBlock(std::vector<char> const& block)
+    {
+        return std::all_of(block.begin(), block.end(), [](char c){ return c == '\0'; });
+    }
+
+    /// The checksum is the sum of the bytes of the header, the bytes of the checksum itself counting as spaces.
+    void checkHeader(std::vector<char> const& header, std::uint64_t headerOffset)
+    {
+        std::uint64_t sum = 0u;
+
+        for (auto i = 0u; i < BlockSize; ++i)
+            sum += i >= Checksum.offset && i < Checksum.offset + Checksum.size ? static_cast<unsigned char>(' ') : static_cast<unsigned char>(header[i]);
+
+        if (sum != parseNumber(header, Checksum, headerOffset))
+            throw std::runtime_error(format("invalid header checksum at offset {}", headerOffset));
+    }
+
+    /// Attributes of the next member, defined by a GNU long name or a pax extended header.
+    struct NextMember
+    {
+        std::optional<std::string> path;
+        bool hasSize = false;
+        std::uint64_t size = 0u;
+    };
+
+    /// Parse the records "<length> <key>=<value>\n" of a pax extended header.
+    void parsePaxRecords(std::string_view records, NextMember& next)
+    {
+        while (!records.empty())
+        {
+            std::size_t length = 0u;
+            auto const [end, error] = std::from_chars(records.data(), records.data() + records.size(), length);
+
+            if (error != std::errc{} || length == 0u || length > records.size())
+                throw std::runtime_error("invalid pax extended header");
+
+            auto const record = records.substr(0u, length);
+            auto const keyBegin = static_cast<std::size_t>(end - records.data()) + 1u;
+            auto const separator = record.find('=', keyBegin);
+
+            if (separator != std::string_view::npos && record.back() == '\n')
+            {
+                auto const key = record.substr(keyBegin, separator - keyBegin);
+                auto const value = record.substr(separator + 1u, record.size() - separator - 2u);
+
+                if (key == "path")
+                    next.path = std::string{value};
+                else if (key == "size")
+                {
+                    std::uint64_t number = 0u;
+                    auto const result = std::from_chars(value.data(), value.data() + value.size(), number);
+
+                    if (result.ec != std::errc{} || result.ptr != value.data() + value.size())
+                        throw std::runtime_error("invalid size in pax extended header");
+
+                    next.hasSize = true;
+                    next.size = number;
+                }
+            }
+
+            records.remove_prefix(length);
+        }
+    }
+
+    std::string cleanPath(std::string path)
+    {
+        while (path.substr(0u, 2u) == "./")
+            path.erase(0u, 2u);
+
+        return path;
+    }
+}
+
+std::vector<TarMember> listTarMembers(TarReader const& read, std::uint64_t archiveSize)
+{
+    std::vector<TarMember> members;
+    std::vector<char> header;
+    std::vector<char> data;
+    NextMember next;
+
+    for (std::uint64_t offset = 0u; offset + BlockSize <= archiveSize;)
+    {
+        read(offset, BlockSize, header);
+
+        // The archive ends with two blocks of zeros
+        if (isZeroBlock(header))
+            break;
+
+        checkHeader(header, offset);
+
+        auto const type = header[TypeFlag.offset];
+        auto const size = next.hasSize ? next.size : parseNumber(header, Size, offset);
+        auto const dataOffset = offset + BlockSize;
+
+        if (size > archiveSize - dataOffset)
+            throw std::runtime_error(format("truncated archive, member at offset {} ends after the end of the archive", offset));
+
+        offset = dataOffset + (size + BlockSize - 1u) / BlockSize * BlockSize;
+
+        // The GNU long names and the pax extended headers apply to the next member
+        if (type == 'L' || type == 'x')
+        {
+            read(dataOffset, static_cast<std::size_t>(size), data);
+
+            if (type == 'L')
+                next.path = std::string{getField(data, Field{0u, data.size()})};
+            else
+                parsePaxRecords(std::string_view{data.data(), data.size()}, next);
+
+            continue;
+        }
+
+        if (type == '0' || type == '\0' || type == '7')
+        {
+            std::string path;
+
+            if (next.path.has_value())
+                path = *next.path;
+            else if (getField(header, Magic) == "ustar" && !getField(header, Prefix).empty())
+                path = std::string{getField(header, Prefix)} + "/" + std::string{getField(header, Name)};
+            else
+                path = std::string{getField(header, Name)};
+
+            path = cleanPath(std::move(path));
+
+            // The path becomes the key of a resource, which may be written in a directory by --apply
+            if (!path.empty() && (!isContainedKey(path) || path.find('\0') != std::string::npos))
+                throw std::runtime_error(format("invalid path '{}' of the member at offset {}, it must be relative and without '..'", path, dataOffset - BlockSize));
+
+            if (!path.empty() && path.back() != '/')
+                members.push_back(TarMember{std::move(path), dataOffset, size});
+        }
+
+        next = NextMember{};
+    }
+
+    return members;
+}
@@ -0,0 +1,26 @@
+#ifndef RESCOM_TAR_HPP
+#define RESCOM_TAR_HPP
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/// \brief Regular file stored in a tar archive
+struct TarMember
+{
+    /// Path of the file inside the archive
+    std::string path;
+    /// Offset of the content of the file in the archive
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+/// Function reading 'size' bytes at 'offset' of the archive into 'buffer'.
+using TarReader = std::function<void(std::uint64_t offset, std::size_t size, std::vector<char>& buffer)>;
+
+/// List the regular files of a tar archive of 'archiveSize' bytes, reading only the headers.
+/// The formats ustar, GNU (long names) and pax (extended headers path and size) are supported.
+/// Throws std::runtime_error if the archive is invalid.
+std::vector<TarMember> listTarMembers(TarReader const& read, std::uint64_t archiveSize);
+
+#endif //RESCOM_TAR_HPP
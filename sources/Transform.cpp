@@ -0,0 +1,459 @@
+#include "Transform.hpp"
+#include "FileSystem.hpp"
+#include "Image.hpp"
+#include "Json.hpp"
+#include "StringHelpers.hpp"
+
+#include <picosha2.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <system_error>
+
+namespace
+{
+    /// Transform without parameter.
+    class SimpleTransform : public Transform
+    {
+        std::string const _name;
+        std::function<void(std::vector<char>&)> const _function;
+    public:
+        SimpleTransform(std::string const& name, std::function<void(std::vector<char>&)>&& function)
+        : _name(name)
+        , _function(std::move(function))
+        {
+        }
+
+        void apply(std::vector<char>& buffer) const override
+        {
+            _function(buffer);
+        }
+
+        std::string identity() const override
+        {
+            return _name;
+        }
+    };
+
+    void stripBom(std::vector<char>& buffer)
+    {
+        static constexpr char const Bom[] = {'\xEF', '\xBB', '\xBF'};
+
+        if (buffer.size() >= std::size(Bom) && std::equal(std::begin(Bom), std::end(Bom), buffer.begin()))
+            buffer.erase(buffer.begin(), buffer.begin() + std::size(Bom));
+    }
+
+    class EndOfLineTransform : public Transform
+    {
+        std::string const _endOfLine;
+    public:
+        explicit EndOfLineTransform(std::string_view endOfLine)
+        : _endOfLine(endOfLine)
+        {
+        }
+
+        void apply(std::vector<char>& buffer) const override
+        {
+            std::vector<char> result;
+
+            result.reserve(buffer.size());
+
+            for (auto i = 0u; i < buffer.size(); ++i)
+            {
+                if (buffer[i] == '\r' && i + 1u < buffer.size() && buffer[i + 1u] == '\n')
+                    continue;
+
+                if (buffer[i] == '\n' || buffer[i] == '\r')
+                    result.insert(result.end(), _endOfLine.begin(), _endOfLine.end());
+                else
+                    result.push_back(buffer[i]);
+            }
+
+            buffer = std::move(result);
+        }
+
+        std::string identity() const override
+        {
+            return _endOfLine == "\n" ? "eol=lf" : "eol=crlf";
+        }
+    };
+
+    /// Remove the spaces at the beginning and at the end of each line, and the empty lines.
+    void minifyWhitespace(std::vector<char>& buffer)
+    {
+        std::string_view text{buffer.data(), buffer.size()};
+        std::vector<char> result;
+
+        result.reserve(buffer.size());
+
+        while (!text.empty())
+        {
+            auto const lineEnd = std::min(text.find('\n'), text.size());
+            auto const line = trim(text.substr(0u, lineEnd));
+
+            text.remove_prefix(std::min(lineEnd + 1u, text.size()));
+
+            if (line.empty())
+                continue;
+
+            result.insert(result.end(), line.begin(), line.end());
+            result.push_back('\n');
+        }
+
+        buffer = std::move(result);
+    }
+
+    /// Remove the spaces outside of the strings. The document is validated first.
+    void minifyJson(std::vector<char>& buffer)
+    {
+        compileJson(buffer);
+
+        std::vector<char> result;
+        bool inString = false;
+
+        result.reserve(buffer.size());
+
+        for (auto i = 0u; i < buffer.size(); ++i)
+        {
+            auto const c = buffer[i];
+
+            if (inString)
+            {
+                result.push_back(c);
+
+                if (c == '\\')
+                    result.push_back(buffer[++i]);
+                else if (c == '"')
+                    inString = false;
+            }
+            else if (c == '"')
+            {
+                inString = true;
+                result.push_back(c);
+            }
+            else if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+            {
+                result.push_back(c);
+            }
+        }
+
+        buffer = std::move(result);
+    }
+
+    /// Remove the comments and the text nodes containing only spaces.
+    /// CDATA sections and processing instructions are kept as is.
+    void minifyXml(std::vector<char>& buffer)
+    {
+        std::string_view text{buffer.data(), buffer.size()};
+        std::vector<char> result;
+        auto const append = [&result](std::string_view part) { result.insert(result.end(), part.begin(), part.end()); };
+        auto const copyUntil = [&text, &append](std::string_view end)
+        {
+            auto const position = text.find(end);
+
+            if (position == std::string_view::npos)
+                throw std::runtime_error(format("'{}' expected", end));
+
+            append(text.substr(0u, position + end.size()));
+            text.remove_prefix(position + end.size());
+        };
+
+        result.reserve(buffer.size());
+
+        while (!text.empty())
+        {
+            if (text.substr(0u, 4u) == "<!--")
+            {
+                auto const end = text.find("-->");
+
+                if (end == std::string_view::npos)
+                    throw std::runtime_error("unterminated comment");
+
+                text.remove_prefix(end + 3u);
+            }
+            else if (text.substr(0u, 9u) == "<![CDATA[")
+            {
+                copyUntil("]]>");
+            }
+            else if (text.front() == '<')
+            {
+                copyUntil(">");
+            }
+            else
+            {
+                auto const textNode = text.substr(0u, std::min(text.find('<'), text.size()));
+
+                if (!trim(textNode).empty())
+                    append(textNode);
+
+                text.remove_prefix(textNode.size());
+            }
+        }
+
+        buffer = std::move(result);
+    }
+
+    /// Directory created in the temporary directory for a single use, removed with its content when destroyed.
+    /// Its name is random and it's created only if it doesn't exist, so concurrent runs of rescom never share it.
+    class TemporaryDirectory
+    {
+        std::filesystem::path _path;
+    public:
+        TemporaryDirectory()
+        {
+            for (auto attempt = 0u; attempt < 16u; ++attempt)
+            {
+                auto path = makeTemporaryPath(std::filesystem::temp_directory_path() / "rescom");
+
+                if (std::filesystem::create_directory(path))
+                {
+                    std::filesystem::permissions(path, std::filesystem::perms::owner_all, std::filesystem::perm_options::replace);
+                    _path = std::move(path);
+                    return;
+                }
+            }
+
+            throw std::runtime_error("unable to create a temporary directory");
+        }
+
+        ~TemporaryDirectory()
+        {
+            std::error_code error;
+
+            std::filesystem::remove_all(_path, error);
+        }
+
+        TemporaryDirectory(TemporaryDirectory const&) = delete;
+        TemporaryDirectory& operator=(TemporaryDirectory const&) = delete;
+
+        std::filesystem::path const& path() const { return _path; }
+    };
+
+    /// Run an external command. The placeholders {input} and {output} in the command are replaced by
+    /// the path of a file containing the content to transform and by the path of the file where the command
+    /// must write the result.
+    class ExecuteTransform : public Transform
+    {
+        std::string const _command;
+    public:
+        explicit ExecuteTransform(std::string_view command)
+        : _command(command)
+        {
+            if (_command.find("{input}") == std::string::npos || _command.find("{output}") == std::string::npos)
+                throw std::runtime_error(format("the command '{}' must contain the placeholders {input} and {output}", _command));
+        }
+
+        void apply(std::vector<char>& buffer) const override
+        {
+            TemporaryDirectory const directory;
+            auto const inputPath = directory.path() / "input";
+            auto const outputPath = directory.path() / "output";
+            auto command = _command;
+
+            replace(command, "{input}", "\"" + inputPath.string() + "\"");
+            replace(command, "{output}", "\"" + outputPath.string() + "\"");
+
+            {
+                std::ofstream file{inputPath, std::ios::binary | std::ios::trunc};
+
+                if (!file.is_open())
+                    throw std::runtime_error(format("unable to write '{}'", inputPath.generic_string()));
+
+                file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            }
+
+            auto const exitCode = std::system(command.c_str());
+
+            if (exitCode != 0)
+                throw std::runtime_error(format("command '{}' failed with code {}", command, exitCode));
+
+            std::ifstream file{outputPath, std::ios::binary};
+
+            if (!file.is_open())
+                throw std::runtime_error(format("command '{}' did not write its output", command));
+
+            buffer.assign(std::istreambuf_iterator<char>(file), {});
+        }
+
+        std::string identity() const override
+        {
+            return "exec=" + _command;
+        }
+    private:
+        static void replace(std::string& text, std::string const& placeholder, std::string const& value)
+        {
+            for (auto position = text.find(placeholder); position != std::string::npos; position = text.find(placeholder, position + value.size()))
+                text.replace(position, placeholder.size(), value);
+        }
+    };
+
+    /// Decode a PNG file into raw pixels preceded by a header, see encodeImage.
+    /// The value is the pixel format, optionally followed by the row alignment: png=rgba8 or png=r8,4
+    class ImageTransform : public Transform
+    {
+        PixelFormat _pixelFormat = PixelFormat::Rgba8;
+        std::size_t _rowAlignment = 1u;
+    public:
+        explicit ImageTransform(std::string_view argument)
+        {
+            auto const separatorPosition = argument.find(',');
+            auto const formatName = argument.substr(0u, separatorPosition);
+
+            if (formatName == "r8")
+                _pixelFormat = PixelFormat::R8;
+            else if (formatName != "rgba8" && !formatName.empty())
+                throw std::runtime_error(format("invalid pixel format '{}', expected 'rgba8' or 'r8'", formatName));
+
+            if (separatorPosition != std::string_view::npos)
+            {
+                auto const alignment = argument.substr(separatorPosition + 1u);
+                auto const [end, error] = std::from_chars(alignment.data(), alignment.data() + alignment.size(), _rowAlignment);
+
+                if (alignment.empty() || error != std::errc{} || end != alignment.data() + alignment.size()
+                    || _rowAlignment == 0u || _rowAlignment > MaxRowAlignment || (_rowAlignment & (_rowAlignment - 1u)) != 0u)
+                {
+                    throw std::runtime_error(format("invalid row alignment '{}', expected a power of 2 up to {}", alignment, MaxRowAlignment));
+                }
+            }
+        }
+
+        void apply(std::vector<char>& buffer) const override
+        {
+            buffer = encodeImage(decodePng(buffer), _pixelFormat, _rowAlignment);
+        }
+
+        std::string identity() const override
+        {
+            return format("png={},{}", _pixelFormat == PixelFormat::R8 ? "r8" : "rgba8", _rowAlignment);
+        }
+    };
+
+    TransformCreator makeSimpleTransform(std::string const& name, void (*function)(std::vector<char>&))
+    {
+        return [name, function](std::string_view argument) -> TransformPointer
+        {
+            if (!argument.empty())
+                throw std::runtime_error(format("option '{}' does not take a value", name));
+
+            return std::make_shared<SimpleTransform>(name, function);
+        };
+    }
+
+    std::map<std::string, TransformCreator>& getFactory()
+    {
+        static std::map<std::string, TransformCreator> factory = {
+            {"strip-bom", makeSimpleTransform("strip-bom", stripBom)},
+            {"minify-whitespace", makeSimpleTransform("minify-whitespace", minifyWhitespace)},
+            {"minify-json", makeSimpleTransform("minify-json", minifyJson)},
+            {"minify-xml", makeSimpleTransform("minify-xml", minifyXml)},
+            {"eol", [](std::string_view argument) -> TransformPointer
+                {
+                    if (argument == "lf")
+                        return std::make_shared<EndOfLineTransform>("\n");
+                    if (argument == "crlf")
+                        return std::make_shared<EndOfLineTransform>("\r\n");
+
+                    throw std::runtime_error(format("invalid end of line '{}', expected 'lf' or 'crlf'", argument));
+                }},
+            {"exec", [](std::string_view argument) -> TransformPointer { return std::make_shared<ExecuteTransform>(argument); }},
+            {"png", [](std::string_view argument) -> TransformPointer { return std::make_shared<ImageTransform>(argument); }},
+        };
+
+        return factory;
+    }
+
+    bool loadCache(std::filesystem::path const& filePath, std::vector<char>& buffer)
+    {
+        std::ifstream file{filePath, std::ios::binary};
+
+        if (!file.is_open())
+            return false;
+
+        buffer.assign(std::istreambuf_iterator<char>(file), {});
+
+        return true;
+    }
+
+    void storeCache(std::filesystem::path const& filePath, std::vector<char> const& buffer)
+    {
+        std::filesystem::create_directories(filePath.parent_path());
+
+        // Write then rename, so a file in the cache is always complete. The cache directory is shared by the
+        // concurrent runs of rescom, each one writes its own temporary file.
+        auto const temporaryPath = makeTemporaryPath(filePath);
+        std::ofstream file{temporaryPath, std::ios::binary | std::ios::trunc};
+
+        if (file.is_open())
+        {
+            file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            file.close();
+        }
+
+        if (!file)
+        {
+            std::error_code error;
+
+            std::filesystem::remove(temporaryPath, error);
+            throw std::runtime_error(format("unable to write '{}'", temporaryPath.generic_string()));
+        }
+
+        std::filesystem::rename(temporaryPath, filePath);
+    }
+}
+
+void registerTransform(std::string const& name, TransformCreator&& creator)
+{
+    getFactory()[name] = std::move(creator);
+}
+
+bool isTransformRegistered(std::string const& name)
+{
+    return getFactory().count(name) > 0u;
+}
+
+TransformPointer instanciateTransform(std::string const& name, std::string_view argument)
+{
+    if (auto it = getFactory().find(name); it != getFactory().end())
+        return it->second(argument);
+
+    throw std::runtime_error(format("invalid transform '{}'", name));
+}
+
+void applyTransforms(std::vector<TransformPointer> const& transforms, std::vector<char>& buffer,
+                     std::optional<std::filesystem::path> const& cacheDirectory)
+{
+    if (transforms.empty())
+        return;
+
+    std::optional<std::filesystem::path> cacheFilePath;
+
+    if (cacheDirectory.has_value())
+    {
+        std::vector<char> key;
+
+        for (auto const& transform : transforms)
+        {
+            auto const identity = transform->identity();
+
+            key.insert(key.end(), identity.begin(), identity.end());
+            key.push_back('\0');
+        }
+
+        key.insert(key.end(), buffer.begin(), buffer.end());
+        cacheFilePath = *cacheDirectory / picosha2::hash256_hex_string(key.begin(), key.end());
+
+        if (loadCache(*cacheFilePath, buffer))
+            return;
+    }
+
+    for (auto const& transform : transforms)
+        transform->apply(buffer);
+
+    if (cacheFilePath.has_value())
+        storeCache(*cacheFilePath, buffer);
+}
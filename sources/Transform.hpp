@@ -0,0 +1,40 @@
+#ifndef RESCOM_TRANSFORM_HPP
+#define RESCOM_TRANSFORM_HPP
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// \brief Transform applied to the content of an input before it's embedded
+/// Transforms are declared as options in the rescom file, they are applied in the order of declaration.
+class Transform
+{
+public:
+    virtual ~Transform() = default;
+
+    /// Transform the content of 'buffer'.
+    /// Throws std::runtime_error if the content can't be transformed.
+    virtual void apply(std::vector<char>& buffer) const = 0;
+
+    /// Returns a text identifying the transform and its parameters, used to cache the results.
+    virtual std::string identity() const = 0;
+};
+
+using TransformPointer = std::shared_ptr<Transform const>;
+using TransformCreator = std::function<TransformPointer(std::string_view argument)>;
+
+/// Register a transform available as option 'name'.
+/// The creator receives the value of the option, it throws std::runtime_error if this value is invalid.
+void registerTransform(std::string const& name, TransformCreator&& creator);
+bool isTransformRegistered(std::string const& name);
+TransformPointer instanciateTransform(std::string const& name, std::string_view argument);
+
+/// Apply the transforms to 'buffer'.
+/// If 'cacheDirectory' is specified the result is stored in this directory, the key being the hash of the content and of the transforms.
+void applyTransforms(std::vector<TransformPointer> const& transforms, std::vector<char>& buffer,
+                     std::optional<std::filesystem::path> const& cacheDirectory);
+
+#endif //RESCOM_TRANSFORM_HPP
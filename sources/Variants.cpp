@@ -0,0 +1,32 @@
+#include "Variants.hpp"
+
+std::string makeVariantKey(VariantGroup const& group, VariantDimension const& dimension, std::size_t value)
+{
+    auto const placeholder = "{" + dimension.name + "}";
+    auto key = group.pattern;
+
+    for (auto position = key.find(placeholder); position != std::string::npos; position = key.find(placeholder, position))
+        key.replace(position, placeholder.size(), dimension.values[value]);
+
+    return key;
+}
+
+std::vector<std::optional<std::size_t>> resolveVariants(VariantGroup const& group, VariantDimension const& dimension,
+                                                        std::function<std::optional<std::size_t>(std::string const&)> const& findInput)
+{
+    std::vector<std::optional<std::size_t>> result;
+    auto const defaultInput = findInput(group.key);
+
+    for (auto value = 0u; value < dimension.values.size(); ++value)
+    {
+        std::optional<std::size_t> input;
+
+        // The parser ensures there is no cycle in the fallbacks.
+        for (std::optional<std::size_t> current = value; current.has_value() && !input.has_value(); current = dimension.fallbacks[*current])
+            input = findInput(makeVariantKey(group, dimension, *current));
+
+        result.push_back(input.has_value() ? input : defaultInput);
+    }
+
+    return result;
+}
@@ -0,0 +1,44 @@
+#ifndef RESCOM_VARIANTS_HPP
+#define RESCOM_VARIANTS_HPP
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+/// \brief Dimension of variation of resources, such as the locale
+/// Declared with: @dimension <name> | <value>[><fallback>] ...
+struct VariantDimension
+{
+    std::string name;
+    /// Values of the dimension, in order of declaration.
+    std::vector<std::string> values;
+    /// For each value, the index of the value to use if a resource does not exist for this value.
+    std::vector<std::optional<std::size_t>> fallbacks;
+    /// The line where this dimension has been declared
+    std::size_t line;
+};
+
+/// \brief Resources varying along a dimension, accessed using the same key
+/// Declared with: @variants <key> = <pattern>
+/// The pattern is the key of the resources, containing the placeholder {<dimension name>}.
+struct VariantGroup
+{
+    std::string key;
+    std::string pattern;
+    /// Index of the dimension
+    std::size_t dimension;
+    /// The line where this group has been declared
+    std::size_t line;
+};
+
+/// Returns the key of the resource of 'group' for a value of its dimension.
+std::string makeVariantKey(VariantGroup const& group, VariantDimension const& dimension, std::size_t value);
+
+/// Resolve the resource to use for each value of the dimension, following the fallbacks.
+/// 'findInput' returns the index of the input having a key, if any.
+/// If no resource is found, the resource having the key of the group is used if it exists.
+std::vector<std::optional<std::size_t>> resolveVariants(VariantGroup const& group, VariantDimension const& dimension,
+                                                        std::function<std::optional<std::size_t>(std::string const&)> const& findInput);
+
+#endif //RESCOM_VARIANTS_HPP
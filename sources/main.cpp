@@ -15,6 +15,9 @@
 #include "StringHelpers.hpp"
 #include "ConfigurationParser.hpp"
 #include "FileSystem.hpp"
+#include "ResourceSet.hpp"
+#include "Delta.hpp"
+#include "Archive.hpp"
 
 void releaseResults(cxxopts::ParseResult const& parseResult, std::ostringstream const& outputStream);
 
@@ -49,14 +52,23 @@ std::vector<std::string> computeInputHashes(Configuration const& configuration)
 
     for (auto const& input : configuration.inputs)
     {
-        std::ifstream ifstream(input.filePath, std::ios::in);
+        std::vector<char> buffer;
+
+        // Members of a tar archive are hashed without reading the whole archive
+        if (input.archiveOffset.has_value())
+        {
+            loadInputContent(input, buffer);
+        }
+        else
+        {
+            std::ifstream ifstream(input.filePath, std::ios::in);
 
-        if (!ifstream.is_open())
-            throw std::runtime_error("Unable to open input file for reading '" + input.filePath.generic_string() + "'");
+            if (!ifstream.is_open())
+                throw std::runtime_error("Unable to open input file for reading '" + input.filePath.generic_string() + "'");
 
-        std::vector<char> buffer;
+            std::copy(std::istream_iterator<char>(ifstream), std::istream_iterator<char>{}, std::back_inserter(buffer));
+        }
 
-        std::copy(std::istream_iterator<char>(ifstream), std::istream_iterator<char>{}, std::back_inserter(buffer));
         actualHashes.push_back(picosha2::hash256_hex_string(buffer));
     }
 
@@ -103,6 +115,36 @@ bool skip(Configuration const& configuration, std::filesystem::path const& witne
     return previousHashes == actualHashes;
 }
 
+ResourceSet loadResourceSetFromFile(std::filesystem::path const& inputFilePath)
+{
+    ConfigurationParser parser{std::make_unique<LocalFileSystem>()};
+
+    return loadResourceSet(parser.parseFile(inputFilePath));
+}
+
+void writeBinaryFile(std::filesystem::path const& filePath, std::vector<char> const& content)
+{
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+
+    if (!file.is_open() || !file.write(content.data(), static_cast<std::streamsize>(content.size())))
+        throw std::runtime_error(format("unable to write '{}'", filePath.generic_string()));
+}
+
+/// Write a patch transforming the resources of 'oldInputFilePath' into the resources of 'inputFilePath'.
+void makeDeltaFile(std::filesystem::path const& oldInputFilePath, std::filesystem::path const& inputFilePath, std::filesystem::path const& outputFilePath)
+{
+    writeBinaryFile(outputFilePath, makeDelta(loadResourceSetFromFile(oldInputFilePath), loadResourceSetFromFile(inputFilePath)));
+}
+
+/// Apply a patch to the resources of 'inputFilePath', then write the new resources into 'outputDirectory'.
+void applyDeltaFile(std::filesystem::path const& patchFilePath, std::filesystem::path const& inputFilePath, std::filesystem::path const& outputDirectory)
+{
+    std::vector<char> patch;
+
+    LocalFileSystem{}.getContent(patchFilePath, patch);
+    writeResourceSet(applyDelta(loadResourceSetFromFile(inputFilePath), patch), outputDirectory);
+}
+
 int main(int argc, char** argv)
 {
     try
@@ -118,6 +160,12 @@ int main(int argc, char** argv)
             ("G,generator", "Generator", cxxopts::value<std::string>())
             ("version", "Print version", cxxopts::value<bool>())
             ("witness", "Witness file", cxxopts::value<std::string>())
+            ("cache", "Directory where the results of the transforms are cached", cxxopts::value<std::string>())
+            ("delta", "Write in the output a patch from the resources of this file to the resources of the input", cxxopts::value<std::string>())
+            ("apply", "Apply this patch to the resources of the input, then write them in the output directory", cxxopts::value<std::string>())
+            ("archive", "Write in the output an archive of the resources, loadable at runtime, instead of the code", cxxopts::value<bool>())
+            ("update", "Update the archive in place, only the new and changed resources are written", cxxopts::value<bool>())
+            ("overlay", "Write in the output an archive of the input replacing resources of this file, loaded at startup", cxxopts::value<std::string>())
             ;
 
         auto parseResult = options.parse(argc, argv);
@@ -130,11 +178,58 @@ int main(int argc, char** argv)
 
         std::filesystem::path const inputFilePath{parseResult["input"].as<std::string>()};
         std::optional<std::filesystem::path> witnessFilePath{getFilePath(parseResult, "witness")};
+
+        if (parseResult.count("delta") > 0 || parseResult.count("apply") > 0)
+        {
+            auto const outputFilePath = getFilePath(parseResult, "output");
+
+            if (!outputFilePath.has_value())
+                throw std::runtime_error("an output is required to make or apply a patch");
+
+            if (auto const oldInputFilePath = getFilePath(parseResult, "delta"); oldInputFilePath.has_value())
+                makeDeltaFile(*oldInputFilePath, inputFilePath, *outputFilePath);
+            else
+                applyDeltaFile(*getFilePath(parseResult, "apply"), inputFilePath, *outputFilePath);
+
+            return 0;
+        }
         std::ostringstream outputStream;
 
         ConfigurationParser parser{std::make_unique<LocalFileSystem>()};
         auto configuration = parser.parseFile(inputFilePath);
 
+        configuration.cacheDirectory = getFilePath(parseResult, "cache");
+
+        if (auto const embeddedFilePath = getFilePath(parseResult, "overlay"); embeddedFilePath.has_value())
+        {
+            auto const outputFilePath = getFilePath(parseResult, "output");
+
+            if (!outputFilePath.has_value())
+                throw std::runtime_error("an output is required to write an overlay");
+
+            checkOverlay(configuration, parser.parseFile(*embeddedFilePath));
+            writeArchive(*outputFilePath, makeTransformedResourceLoaders(configuration));
+
+            return 0;
+        }
+
+        if (parseResult["archive"].count() > 0)
+        {
+            auto const outputFilePath = getFilePath(parseResult, "output");
+
+            if (!outputFilePath.has_value())
+                throw std::runtime_error("an output is required to write an archive");
+
+            auto const resources = makeTransformedResourceLoaders(configuration);
+
+            if (parseResult["update"].count() > 0)
+                updateArchive(*outputFilePath, resources);
+            else
+                writeArchive(*outputFilePath, resources);
+
+            return 0;
+        }
+
         if (witnessFilePath.has_value() && skip(configuration, *witnessFilePath))
         {
             // Nothing changed since the last run.
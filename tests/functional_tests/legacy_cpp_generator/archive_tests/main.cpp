@@ -0,0 +1,159 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+#include <rescom.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    std::string loadFile(std::filesystem::path const& path)
+    {
+        std::ifstream file{path, std::ios::binary};
+
+        return std::string(std::istreambuf_iterator<char>(file), {});
+    }
+
+    std::string getArchivePath(char const* name)
+    {
+        return (std::filesystem::path(RESOURCES_BINARY_DIRECTORY) / name).string();
+    }
+
+    std::string const FirstData = loadFile(std::filesystem::path(RESOURCES_DIRECTORY) / "first" / "data.txt");
+    std::string const SecondData = loadFile(std::filesystem::path(RESOURCES_DIRECTORY) / "second" / "data.txt");
+}
+
+TEST_CASE("no archive loaded", "[ArchiveTests]") {
+    rescom::ArchiveSnapshot const snapshot;
+
+    REQUIRE( !snapshot.valid() );
+    REQUIRE( snapshot.size() == 0u );
+    REQUIRE( snapshot.getText("version.txt").empty() );
+}
+
+TEST_CASE("invalid archives", "[ArchiveTests]") {
+    REQUIRE( !rescom::reload(getArchivePath("yolo.rca").c_str()) );
+    REQUIRE( !rescom::reload((std::filesystem::path(RESOURCES_DIRECTORY) / "files.rescom").string().c_str()) );
+    REQUIRE( !rescom::ArchiveSnapshot{}.valid() );
+}
+
+TEST_CASE("reload", "[ArchiveTests]") {
+    REQUIRE( rescom::reload(getArchivePath("first.rca").c_str()) );
+    {
+        rescom::ArchiveSnapshot const snapshot;
+
+        REQUIRE( snapshot.valid() );
+        REQUIRE( snapshot.size() == 3u );
+        REQUIRE( snapshot.getText("version.txt") == "first" );
+        REQUIRE( snapshot.getText("data.txt") == FirstData );
+        REQUIRE( snapshot.contains("only_first.txt") );
+        REQUIRE( !snapshot.contains("yolo.txt") );
+        REQUIRE( snapshot.getText("yolo.txt").empty() );
+    }
+
+    REQUIRE( rescom::reload(getArchivePath("second.rca").c_str()) );
+    {
+        rescom::ArchiveSnapshot const snapshot;
+
+        REQUIRE( snapshot.size() == 2u );
+        REQUIRE( snapshot.getText("version.txt") == "second" );
+        REQUIRE( snapshot.getText("data.txt") == SecondData );
+        REQUIRE( !snapshot.contains("only_first.txt") );
+    }
+}
+
+TEST_CASE("corrupted archive", "[ArchiveTests]") {
+    REQUIRE( rescom::reload(getArchivePath("first.rca").c_str()) );
+
+    auto const generation = rescom::ArchiveSnapshot{}.generation();
+    auto content = loadFile(getArchivePath("second.rca"));
+
+    // Change one byte of the first payload, stored after the two headers
+    content[128u] ^= 0x01;
+    std::ofstream{getArchivePath("corrupted.rca"), std::ios::binary} << content;
+
+    REQUIRE( !rescom::reload(getArchivePath("corrupted.rca").c_str()) );
+
+    rescom::ArchiveSnapshot const snapshot;
+
+    REQUIRE( snapshot.generation() == generation );
+    REQUIRE( snapshot.getText("version.txt") == "first" );
+}
+
+TEST_CASE("snapshot keeps its archive", "[ArchiveTests]") {
+    REQUIRE( rescom::reload(getArchivePath("first.rca").c_str()) );
+
+    auto snapshot = std::make_unique<rescom::ArchiveSnapshot>();
+    auto const data = snapshot->getText("data.txt");
+
+    // reload() does not wait for the snapshot, even in the thread holding it
+    REQUIRE( rescom::reload(getArchivePath("second.rca").c_str()) );
+    REQUIRE( rescom::reload(getArchivePath("second.rca").c_str()) );
+    REQUIRE( data == FirstData );
+    REQUIRE( snapshot->getText("version.txt") == "first" );
+    REQUIRE( rescom::ArchiveSnapshot{}.getText("version.txt") == "second" );
+    REQUIRE( rescom::ArchiveSnapshot{}.generation() == snapshot->generation() + 2u );
+
+    // The last snapshot of the first archive deletes it
+    REQUIRE( rescom::details::archiveState().retired.size() == 1u );
+    snapshot.reset();
+    REQUIRE( rescom::details::archiveState().retired.empty() );
+    REQUIRE( rescom::ArchiveSnapshot{}.getText("version.txt") == "second" );
+}
+
+TEST_CASE("reload while reading", "[ArchiveTests]") {
+    static constexpr unsigned int const ReaderCount = 4u;
+    static constexpr unsigned int const ReloadCount = 200u;
+    std::atomic<bool> stop{false};
+    std::atomic<unsigned int> errors{0u};
+    std::atomic<unsigned int> reads{0u};
+    std::vector<std::thread> readers;
+    unsigned int reloads = 0u;
+
+    REQUIRE( rescom::reload(getArchivePath("first.rca").c_str()) );
+
+    for (auto i = 0u; i < ReaderCount; ++i)
+    {
+        readers.emplace_back([&]
+        {
+            std::uint64_t generation = 0u;
+
+            while (!stop)
+            {
+                rescom::ArchiveSnapshot const snapshot;
+                auto const version = snapshot.getText("version.txt");
+                auto const data = snapshot.getText("data.txt");
+                // Every resource read with the same snapshot comes from the same archive
+                bool const valid = (version == "first" && data == FirstData && snapshot.contains("only_first.txt"))
+                                || (version == "second" && data == SecondData && !snapshot.contains("only_first.txt"));
+
+                if (!valid || snapshot.generation() < generation)
+                    ++errors;
+
+                generation = snapshot.generation();
+                ++reads;
+            }
+        });
+    }
+
+    for (auto i = 0u; i < ReloadCount; ++i)
+    {
+        if (rescom::reload(getArchivePath(i % 2u == 0u ? "second.rca" : "first.rca").c_str()))
+            ++reloads;
+    }
+
+    stop = true;
+    for (auto& reader : readers)
+        reader.join();
+
+    REQUIRE( reloads == ReloadCount );
+    REQUIRE( errors == 0u );
+    REQUIRE( reads > 0u );
+}
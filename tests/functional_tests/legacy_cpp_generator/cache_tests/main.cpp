@@ -0,0 +1,137 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+#include <rescom.hpp>
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    std::atomic<unsigned int> decodeCount{0u};
+
+    std::vector<int> parseNumbers(std::string_view text)
+    {
+        std::istringstream stream{std::string{text}};
+        std::vector<int> numbers;
+
+        ++decodeCount;
+        for (int number = 0; stream >> number;)
+            numbers.push_back(number);
+
+        return numbers;
+    }
+}
+
+TEST_CASE("decoded once", "[CacheTests]") {
+    rescom::clearCache();
+    decodeCount = 0u;
+
+    auto const before = rescom::cacheStatistics();
+    auto const first = rescom::cached<std::vector<int>>("numbers.txt", parseNumbers);
+    auto const second = rescom::cached<std::vector<int>>("numbers.txt", parseNumbers);
+    auto const after = rescom::cacheStatistics();
+
+    REQUIRE( first != nullptr );
+    REQUIRE( *first == std::vector<int>{1, 2, 3, 4} );
+    REQUIRE( first == second );
+    REQUIRE( decodeCount == 1u );
+    REQUIRE( after.misses == before.misses + 1u );
+    REQUIRE( after.hits == before.hits + 1u );
+    REQUIRE( after.entries == 1u );
+    REQUIRE( after.bytes == sizeof(std::vector<int>) + 4u * sizeof(int) );
+    REQUIRE( after.budget == 1024u );
+}
+
+TEST_CASE("one slot per type", "[CacheTests]") {
+    rescom::clearCache();
+
+    auto const numbers = rescom::cached<std::vector<int>>("tens.txt", parseNumbers);
+    auto const text = rescom::cached<std::string>("tens.txt", [](std::string_view text){ return std::string{text}; });
+
+    REQUIRE( numbers->size() == 3u );
+    REQUIRE( *text == "10 20 30" );
+    REQUIRE( rescom::cacheStatistics().entries == 2u );
+}
+
+TEST_CASE("missing resource", "[CacheTests]") {
+    REQUIRE( rescom::cached<std::vector<int>>("yolo.txt", parseNumbers) == nullptr );
+}
+
+TEST_CASE("least recently used eviction", "[CacheTests]") {
+    rescom::clearCache();
+    rescom::setCacheBudget(1024u);
+    decodeCount = 0u;
+
+    auto const cost = [](std::vector<int> const&) -> std::size_t { return 400u; };
+    auto const before = rescom::cacheStatistics();
+
+    rescom::cached<std::vector<int>>("numbers.txt", parseNumbers, cost);
+    rescom::cached<std::vector<int>>("tens.txt", parseNumbers, cost);
+    rescom::cached<std::vector<int>>("numbers.txt", parseNumbers, cost);
+    // tens.txt is the least recently used
+    rescom::cached<std::vector<int>>("hundreds.txt", parseNumbers, cost);
+
+    auto const statistics = rescom::cacheStatistics();
+
+    REQUIRE( statistics.evictions == before.evictions + 1u );
+    REQUIRE( statistics.entries == 2u );
+    REQUIRE( statistics.bytes == 800u );
+    REQUIRE( decodeCount == 3u );
+
+    rescom::cached<std::vector<int>>("numbers.txt", parseNumbers, cost);
+    REQUIRE( decodeCount == 3u );
+    rescom::cached<std::vector<int>>("tens.txt", parseNumbers, cost);
+    REQUIRE( decodeCount == 4u );
+
+    // An object larger than the budget is returned but not kept
+    auto const large = rescom::cached<std::vector<int>>("tens.txt", parseNumbers, [](std::vector<int> const&) -> std::size_t { return 2048u; });
+
+    REQUIRE( large != nullptr );
+
+    // A value evicted stays valid for its owners
+    auto const kept = rescom::cached<std::vector<int>>("numbers.txt", parseNumbers, cost);
+
+    rescom::setCacheBudget(0u);
+    REQUIRE( rescom::cacheStatistics().entries == 0u );
+    REQUIRE( kept->size() == 4u );
+    rescom::setCacheBudget(1024u);
+}
+
+TEST_CASE("concurrent accesses", "[CacheTests]") {
+    rescom::clearCache();
+    decodeCount = 0u;
+
+    std::vector<std::thread> threads;
+    std::atomic<unsigned int> errors{0u};
+
+    for (auto i = 0u; i < 8u; ++i)
+    {
+        threads.emplace_back([&errors, i]
+        {
+            static char const* const Keys[] = {"numbers.txt", "tens.txt", "hundreds.txt"};
+
+            for (auto j = 0u; j < 2000u; ++j)
+            {
+                auto const numbers = rescom::cached<std::vector<int>>(Keys[(i + j) % 3u], parseNumbers);
+
+                if (numbers == nullptr || numbers->empty())
+                    ++errors;
+
+                // Force evictions while other threads read
+                if (j % 500u == 0u)
+                    rescom::setCacheBudget(j % 1000u == 0u ? 100u : 1024u);
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    rescom::setCacheBudget(1024u);
+    REQUIRE( errors == 0u );
+    REQUIRE( rescom::cacheStatistics().hits > 0u );
+}
@@ -0,0 +1,99 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+#include <rescom.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    std::string loadFile(char const* key)
+    {
+        std::ifstream file{std::filesystem::path(RESOURCES_DIRECTORY) / key, std::ios::binary};
+
+        return std::string(std::istreambuf_iterator<char>(file), {});
+    }
+}
+
+TEST_CASE("compressed resource", "[CompressionTests]") {
+    rescom::Reader reader{"records.txt"};
+    auto const expected = loadFile("records.txt");
+
+    REQUIRE( reader.valid() );
+    REQUIRE( reader.size() == expected.size() );
+    REQUIRE( reader.frameSize() == 1024u );
+    REQUIRE( reader.frameCount() == 10u );
+    REQUIRE( rescom::getResource("records.txt").size < expected.size() );
+}
+
+TEST_CASE("random access", "[CompressionTests]") {
+    rescom::Reader reader{"records.txt"};
+    auto const expected = loadFile("records.txt");
+    std::string buffer(3000u, '\0');
+
+    // Inside one frame, across frames and covering whole frames
+    for (auto const& [offset, length] : {std::pair{0u, 10u}, {1020u, 10u}, {5000u, 3000u}, {1024u, 2048u}, {9500u, 100u}})
+    {
+        auto const count = reader.read(offset, length, buffer.data());
+        auto const expectedCount = std::min<std::size_t>(length, expected.size() - offset);
+
+        REQUIRE( count == expectedCount );
+        REQUIRE( buffer.substr(0u, count) == expected.substr(offset, count) );
+    }
+
+    REQUIRE( reader.read(expected.size(), 10u, buffer.data()) == 0u );
+}
+
+TEST_CASE("streaming", "[CompressionTests]") {
+    rescom::Reader reader{"records.txt"};
+    std::string result;
+    char buffer[700];
+
+    while (!reader.eof())
+        result.append(buffer, reader.read(buffer, sizeof(buffer)));
+
+    REQUIRE( result == loadFile("records.txt") );
+    REQUIRE( reader.tell() == result.size() );
+
+    reader.seek(7u);
+    REQUIRE( reader.read(buffer, 4u) == 4u );
+    REQUIRE( std::string(buffer, 4u) == "0000" );
+}
+
+TEST_CASE("parallel decoding", "[CompressionTests]") {
+    rescom::Reader const reader{"records.txt"};
+    std::string result(reader.size(), '\0');
+    std::vector<std::thread> threads;
+
+    for (auto i = 0u; i < reader.frameCount(); ++i)
+        threads.emplace_back([&reader, &result, i]{ reader.decodeFrame(i, result.data() + i * reader.frameSize()); });
+
+    for (auto& thread : threads)
+        thread.join();
+
+    REQUIRE( result == loadFile("records.txt") );
+}
+
+TEST_CASE("small and plain resources", "[CompressionTests]") {
+    rescom::Reader small{"small.txt"};
+    rescom::Reader plain{"plain.txt"};
+    rescom::Reader missing{"yolo.txt"};
+    char buffer[32];
+
+    REQUIRE( small.frameCount() == 1u );
+    REQUIRE( small.read(0u, sizeof(buffer), buffer) == 4u );
+    REQUIRE( std::string(buffer, 4u) == "tiny" );
+    REQUIRE( plain.size() == rescom::getText("plain.txt").size() );
+    REQUIRE( plain.read(6u, 4u, buffer) == 4u );
+    REQUIRE( std::string(buffer, 4u) == "text" );
+    REQUIRE_FALSE( missing.valid() );
+    REQUIRE( missing.size() == 0u );
+    REQUIRE( missing.read(buffer, sizeof(buffer)) == 0u );
+}
@@ -0,0 +1,45 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+#include <rescom.hpp>
+
+#include <string>
+
+TEST_CASE("map find", "[DictionaryTests]") {
+    auto const messages = rescom::map("messages.txt");
+
+    REQUIRE( messages.size() == 4 );
+    REQUIRE( messages.find("hello") != nullptr );
+    REQUIRE( messages.find("hello")->key == "hello" );
+    REQUIRE( messages.find("hello")->value == "Bonjour" );
+    REQUIRE( messages.find("yolo") == nullptr );
+    REQUIRE( messages.find("") == nullptr );
+}
+
+TEST_CASE("map get", "[DictionaryTests]") {
+    auto const messages = rescom::map("messages.txt");
+
+    REQUIRE( messages.get("goodbye") == "Au revoir" );
+    REQUIRE( messages.get("multiline") == "first\nsecond" );
+    REQUIRE( messages.contains("empty") );
+    REQUIRE( messages.get("empty", "fallback").empty() );
+    REQUIRE( messages.get("yolo", "fallback") == "fallback" );
+}
+
+TEST_CASE("set contains", "[DictionaryTests]") {
+    auto const stopWords = rescom::set("stopwords.txt");
+
+    REQUIRE( stopWords.size() == 122 );
+    REQUIRE( stopWords.contains("the") );
+    REQUIRE( stopWords.contains("yourselves") );
+    REQUIRE( stopWords.contains(std::string("a")) );
+    REQUIRE( !stopWords.contains("rescom") );
+    REQUIRE( !stopWords.contains("# English stop words") );
+}
+
+TEST_CASE("invalid dictionaries", "[DictionaryTests]") {
+    REQUIRE( rescom::map("stopwords.txt").empty() );
+    REQUIRE( rescom::set("messages.txt").empty() );
+    REQUIRE( rescom::map("test_invalid_key.txt").find("hello") == nullptr );
+    REQUIRE( !rescom::set("test.txt").contains("Hello world!") );
+}
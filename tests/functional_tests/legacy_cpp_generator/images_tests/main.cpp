@@ -0,0 +1,55 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+#include <rescom.hpp>
+
+#include <cstdint>
+
+TEST_CASE("rgba8 image", "[ImagesTests]") {
+    auto const image = rescom::image("cp437_20x20.png");
+    unsigned int whitePixels = 0u;
+
+    REQUIRE( image.valid() );
+    REQUIRE( image.width == 320u );
+    REQUIRE( image.height == 320u );
+    REQUIRE( image.stride == 320u * 4u );
+    REQUIRE( image.format == rescom::PixelFormat::Rgba8 );
+    REQUIRE( reinterpret_cast<std::uintptr_t>(image.pixels) % 16u == 0u );
+
+    for (auto y = 0u; y < image.height; ++y)
+    {
+        for (auto const* pixel = image.row(y); pixel != image.row(y) + image.width * 4u; pixel += 4)
+        {
+            REQUIRE( ((pixel[0] == 0u && pixel[1] == 0u && pixel[2] == 0u) || (pixel[0] == 255u && pixel[1] == 255u && pixel[2] == 255u)) );
+            REQUIRE( pixel[3] == 255u );
+
+            whitePixels += pixel[0] == 255u ? 1u : 0u;
+        }
+    }
+
+    REQUIRE( whitePixels == 27947u );
+}
+
+TEST_CASE("r8 image with aligned rows", "[ImagesTests]") {
+    auto const image = rescom::image("gradient.png");
+
+    REQUIRE( image.valid() );
+    REQUIRE( image.width == 3u );
+    REQUIRE( image.height == 2u );
+    REQUIRE( image.stride == 64u );
+    REQUIRE( image.format == rescom::PixelFormat::R8 );
+    REQUIRE( reinterpret_cast<std::uintptr_t>(image.row(0u)) % 64u == 0u );
+    REQUIRE( reinterpret_cast<std::uintptr_t>(image.row(1u)) % 64u == 0u );
+    REQUIRE( image.row(0u)[0] == 0u );
+    REQUIRE( image.row(0u)[1] == 128u );
+    REQUIRE( image.row(0u)[2] == 255u );
+    REQUIRE( image.row(1u)[0] == 64u );
+    REQUIRE( image.row(1u)[1] == 32u );
+    REQUIRE( image.row(1u)[2] == 16u );
+}
+
+TEST_CASE("not an image", "[ImagesTests]") {
+    REQUIRE( !rescom::image("notes.txt").valid() );
+    REQUIRE( !rescom::image("missing.png").valid() );
+    REQUIRE( rescom::image("missing.png").width == 0u );
+}
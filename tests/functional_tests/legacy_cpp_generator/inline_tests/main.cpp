@@ -0,0 +1,41 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+#include <rescom.hpp>
+
+#include <string_view>
+
+using namespace std::string_view_literals;
+
+TEST_CASE("inline resources", "[InlineTests]") {
+    auto const& version = rescom::getResource("version.txt");
+
+    REQUIRE( version.isInline() );
+    REQUIRE( version.bytes == version.inlineBytes );
+    REQUIRE( rescom::getText("version.txt") == "1.2.3" );
+    REQUIRE( rescom::getResource("sixteen.txt").isInline() );
+    REQUIRE( rescom::getText("sixteen.txt") == "0123456789abcdef" );
+    REQUIRE( rescom::getResource("empty.txt").isInline() );
+    REQUIRE( rescom::getText("empty.txt").empty() );
+}
+
+TEST_CASE("inline binary resource", "[InlineTests]") {
+    REQUIRE( rescom::getResource("binary.bin").isInline() );
+    REQUIRE( rescom::getText("binary.bin") == "a\0\"\\\n\xff"sv );
+}
+
+TEST_CASE("resources not inline", "[InlineTests]") {
+    REQUIRE_FALSE( rescom::getResource("seventeen.txt").isInline() );
+    REQUIRE( rescom::getText("seventeen.txt") == "0123456789abcdefg" );
+    REQUIRE_FALSE( rescom::getResource("small.json").isInline() );
+    REQUIRE( rescom::json("small.json")[1].asInteger() == 2 );
+}
+
+TEST_CASE("iterate inline resources", "[InlineTests]") {
+    auto count = 0u;
+
+    for (auto it = rescom::begin(); it != rescom::end(); ++it)
+        count += it->isInline() ? 1u : 0u;
+
+    REQUIRE( count == 4u );
+}
@@ -0,0 +1,53 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+#include <rescom.hpp>
+
+#include <string>
+
+TEST_CASE("json root", "[JsonTests]") {
+    auto const config = rescom::json("config.json");
+
+    REQUIRE( config.type() == rescom::JsonType::Object );
+    REQUIRE( config.size() == 7 );
+    REQUIRE( config.keyAt(0) == "enabled" );
+    REQUIRE( config.keyAt(6) == "window" );
+}
+
+TEST_CASE("json scalars", "[JsonTests]") {
+    auto const config = rescom::json("config.json");
+
+    REQUIRE( config["name"].asString() == "rescom" );
+    REQUIRE( config["version"].asInteger() == 3 );
+    REQUIRE( config["version"].asNumber() == 3. );
+    REQUIRE( config["ratio"].asNumber() == 0.75 );
+    REQUIRE( config["enabled"].asBool() );
+    REQUIRE( config["parent"].isNull() );
+    REQUIRE( config["parent"].exists() );
+}
+
+TEST_CASE("json containers", "[JsonTests]") {
+    auto const config = rescom::json("config.json");
+
+    REQUIRE( config["tags"].size() == 3 );
+    REQUIRE( config["tags"][2].asString() == "c++" );
+    REQUIRE( config["window"]["width"].asInteger() == 1280 );
+    REQUIRE( config["window"]["title"].asString() == "Caf\xc3\xa9" );
+}
+
+TEST_CASE("json missing values", "[JsonTests]") {
+    auto const config = rescom::json("config.json");
+
+    REQUIRE( !config["yolo"].exists() );
+    REQUIRE( config["yolo"]["deeper"].type() == rescom::JsonType::Undefined );
+    REQUIRE( config["tags"][3].asString("fallback") == "fallback" );
+    REQUIRE( config["name"].asInteger(-1) == -1 );
+    REQUIRE( !config.contains("yolo") );
+    REQUIRE( config.contains("ratio") );
+}
+
+TEST_CASE("json invalid resource", "[JsonTests]") {
+    REQUIRE( !rescom::json("test.txt").exists() );
+    REQUIRE( !rescom::json("test_invalid_key.json").exists() );
+    REQUIRE( std::string(rescom::getText("test.txt")) == "Hello world!" );
+}
@@ -0,0 +1,43 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+#include <rescom.hpp>
+
+#include <string>
+
+TEST_CASE("lineCount", "[LinesTests]") {
+    REQUIRE( rescom::lineCount("lines.txt") == 200 );
+    REQUIRE( rescom::lineCount("windows.txt") == 4 );
+    REQUIRE( rescom::lineCount("test.txt") == 0 );
+    REQUIRE( rescom::lineCount("test_invalid_key.txt") == 0 );
+}
+
+TEST_CASE("line", "[LinesTests]") {
+    for (auto i = 0u; i < 200u; ++i)
+        REQUIRE( std::string(rescom::line("lines.txt", i)) == "Line " + std::to_string(i) + " of the file" );
+
+    REQUIRE( rescom::line("lines.txt", 200).empty() );
+    REQUIRE( rescom::line("test_invalid_key.txt", 0).empty() );
+}
+
+TEST_CASE("line with carriage return", "[LinesTests]") {
+    REQUIRE( std::string(rescom::line("windows.txt", 0)) == "first" );
+    REQUIRE( std::string(rescom::line("windows.txt", 1)) == "second" );
+    REQUIRE( std::string(rescom::line("windows.txt", 2)) == "" );
+    REQUIRE( std::string(rescom::line("windows.txt", 3)) == "last" );
+}
+
+TEST_CASE("line iterator", "[LinesTests]") {
+    auto i = 0u;
+
+    for (auto line : rescom::lines("lines.txt"))
+        REQUIRE( std::string(line) == "Line " + std::to_string(i++) + " of the file" );
+
+    REQUIRE( i == 200u );
+    REQUIRE( rescom::lines("test.txt").begin() == rescom::lines("test.txt").end() );
+}
+
+TEST_CASE("getText unchanged", "[LinesTests]") {
+    REQUIRE( std::string(rescom::getText("test.txt")) == "Hello world!" );
+    REQUIRE( rescom::getText("windows.txt").size() == 21 );
+}
@@ -0,0 +1,60 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+#include <rescom.hpp>
+
+#include <string>
+
+TEST_CASE("replaced resource", "[OverlayTests]") {
+    REQUIRE( rescom::isOverlaid("version.txt") );
+    REQUIRE( rescom::contains("version.txt") );
+    REQUIRE( rescom::getText("version.txt") == "1.1-hotfix\n" );
+    REQUIRE( rescom::getResource("version.txt").size == 11u );
+}
+
+TEST_CASE("embedded resources", "[OverlayTests]") {
+    REQUIRE( !rescom::isOverlaid("message.txt") );
+    REQUIRE( rescom::getText("message.txt") == "Hello\n" );
+    REQUIRE( rescom::lineCount("numbers.txt") == 3u );
+    REQUIRE( rescom::line("numbers.txt", 1u) == "2" );
+}
+
+TEST_CASE("side tables of a replaced resource", "[OverlayTests]") {
+    rescom::Reader reader{"version.txt"};
+    char buffer[32];
+
+    REQUIRE( rescom::lineCount("version.txt") == 0u );
+    REQUIRE( rescom::line("version.txt", 0u).empty() );
+    REQUIRE( reader.size() == 11u );
+    REQUIRE( reader.read(0u, sizeof(buffer), buffer) == 11u );
+    REQUIRE( std::string(buffer, 11u) == "1.1-hotfix\n" );
+    REQUIRE( rescom::Reader{"records.txt"}.frameCount() == 3u );
+}
+
+TEST_CASE("replaced variant", "[OverlayTests]") {
+    REQUIRE( rescom::isOverlaid("greeting/fr.txt") );
+    REQUIRE( rescom::getText("greeting.txt", "fr") == "Salut" );
+    REQUIRE( rescom::getText("greeting.txt", rescom::getVariant("locale", "fr")) == "Salut" );
+    REQUIRE( &rescom::getResource("greeting.txt", "fr") == &rescom::getResource("greeting.txt", rescom::getVariant("locale", "fr")) );
+    REQUIRE( rescom::getText("greeting.txt", "en") == "Hello" );
+}
+
+TEST_CASE("key of the overlay not embedded", "[OverlayTests]") {
+    REQUIRE( !rescom::contains("hello.txt") );
+    REQUIRE( !rescom::isOverlaid("hello.txt") );
+    REQUIRE( !rescom::isOverlaid("message.txt") );
+    REQUIRE( rescom::getText("message.txt") == "Hello\n" );
+}
+
+TEST_CASE("missing resource", "[OverlayTests]") {
+    REQUIRE( !rescom::isOverlaid("missing.txt") );
+    REQUIRE( !rescom::contains("missing.txt") );
+}
+
+TEST_CASE("cached replaced resource", "[OverlayTests]") {
+    auto const text = rescom::cached<std::string>("version.txt", [](std::string_view text){ return std::string{text}; });
+    auto const again = rescom::cached<std::string>("version.txt", [](std::string_view text){ return std::string{text}; });
+
+    REQUIRE( *text == "1.1-hotfix\n" );
+    REQUIRE( text == again );
+}
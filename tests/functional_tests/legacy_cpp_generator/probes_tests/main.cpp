@@ -0,0 +1,79 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+#include <rescom.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    std::string loadFile(char const* key)
+    {
+        std::ifstream file{std::filesystem::path(RESOURCES_DIRECTORY) / key, std::ios::binary};
+
+        return std::string(std::istreambuf_iterator<char>(file), {});
+    }
+
+    std::vector<int> parseNumbers(std::string_view text)
+    {
+        std::istringstream stream{std::string{text}};
+        std::vector<int> numbers;
+
+        for (int number = 0; stream >> number;)
+            numbers.push_back(number);
+
+        return numbers;
+    }
+}
+
+// RESCOM_PROBE calls the probes of the namespace 'details'
+namespace details
+{
+    inline void countProbe(int& count) { ++count; }
+}
+
+TEST_CASE("lookups", "[ProbesTests]") {
+    REQUIRE( rescom::getText("numbers.txt") == "1 2 3 4" );
+    REQUIRE( rescom::getResource("missing.txt").bytes == nullptr );
+    REQUIRE( rescom::getResource("missing.txt").size == 0u );
+}
+
+TEST_CASE("decompression", "[ProbesTests]") {
+    rescom::Reader reader{"lorem.txt"};
+    auto const expected = loadFile("lorem.txt");
+    std::string result(reader.size(), '\0');
+
+    REQUIRE( reader.frameCount() > 1u );
+    REQUIRE( reader.read(result.data(), result.size()) == expected.size() );
+    REQUIRE( result == expected );
+}
+
+TEST_CASE("decoding", "[ProbesTests]") {
+    rescom::clearCache();
+
+    auto const first = rescom::cached<std::vector<int>>("numbers.txt", parseNumbers);
+    auto const second = rescom::cached<std::vector<int>>("numbers.txt", parseNumbers);
+
+    REQUIRE( *first == std::vector<int>{1, 2, 3, 4} );
+    REQUIRE( first == second );
+}
+
+TEST_CASE("probe in a conditional", "[ProbesTests]") {
+    [[maybe_unused]] auto probes = 0;
+    auto others = 0;
+
+    for (auto const condition : {true, false})
+    {
+        if (condition)
+            RESCOM_PROBE(countProbe(probes));
+        else
+            ++others;
+    }
+
+    REQUIRE( others == 1 );
+}
@@ -0,0 +1,57 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+#include <rescom.hpp>
+
+#include <cstdint>
+#include <limits>
+#include <numeric>
+
+TEST_CASE("columnCount", "[TablesTests]") {
+    REQUIRE( rescom::columnCount("calibration.csv") == 3 );
+    REQUIRE( rescom::columnCount("grid.csv") == 2 );
+    REQUIRE( rescom::columnCount("test_invalid_key.csv") == 0 );
+}
+
+TEST_CASE("table by index", "[TablesTests]") {
+    auto const temperatures = rescom::table<float>("calibration.csv", 0);
+
+    REQUIRE( temperatures.size == 3 );
+    REQUIRE( temperatures[0] == -40.5f );
+    REQUIRE( temperatures[1] == 0.f );
+    REQUIRE( temperatures[2] == 25.125f );
+    REQUIRE( std::accumulate(temperatures.begin(), temperatures.end(), 0.f) == -15.375f );
+}
+
+TEST_CASE("table by name", "[TablesTests]") {
+    auto const resistances = rescom::table<double>("calibration.csv", "resistance");
+    auto const codes = rescom::table<std::int32_t>("calibration.csv", "code");
+
+    REQUIRE( resistances.size == 3 );
+    REQUIRE( resistances[2] == 960.0625 );
+    REQUIRE( codes.size == 3 );
+    REQUIRE( codes[0] == -3 );
+    REQUIRE( rescom::table<double>("calibration.csv", "yolo").empty() );
+}
+
+TEST_CASE("table limits", "[TablesTests]") {
+    REQUIRE( rescom::table<std::uint8_t>("grid.csv", 0)[1] == 255 );
+    REQUIRE( rescom::table<std::int64_t>("grid.csv", 1)[0] == std::numeric_limits<std::int64_t>::min() );
+    REQUIRE( rescom::table<std::int64_t>("grid.csv", 1)[1] == std::numeric_limits<std::int64_t>::max() );
+}
+
+TEST_CASE("table type mismatch", "[TablesTests]") {
+    REQUIRE( rescom::table<double>("calibration.csv", 0).empty() );
+    REQUIRE( rescom::table<float>("calibration.csv", 3).empty() );
+    REQUIRE( rescom::table<float>("test_invalid_key.csv", 0).empty() );
+}
+
+TEST_CASE("table alignment", "[TablesTests]") {
+    REQUIRE( reinterpret_cast<std::uintptr_t>(rescom::table<float>("calibration.csv", 0).data) % 64u == 0u );
+    REQUIRE( reinterpret_cast<std::uintptr_t>(rescom::table<double>("calibration.csv", 1).data) % 64u == 0u );
+}
+
+TEST_CASE("empty table", "[TablesTests]") {
+    REQUIRE( rescom::columnCount("empty.csv") == 1 );
+    REQUIRE( rescom::table<float>("empty.csv", "value").empty() );
+}
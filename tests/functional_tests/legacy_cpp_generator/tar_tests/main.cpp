@@ -0,0 +1,26 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+#include <rescom.hpp>
+
+#include <string>
+
+TEST_CASE("archive members", "[TarTests]") {
+    REQUIRE( rescom::getText("icons/close.svg") == "<svg><path d=\"M0 0L8 8\"/></svg>" );
+    REQUIRE( rescom::getText("icons/open.svg") == "<svg><path d=\"M0 8L8 0\"/></svg>" );
+    auto const longPath = "deep/" + std::string(110u, 'x') + "/note.txt";
+
+    REQUIRE( rescom::getText(longPath.c_str()) == "a member with a long path" );
+    REQUIRE( rescom::getText("quotes/say \"hi\" \\ bye.txt") == "escaped key" );
+}
+
+TEST_CASE("archive member options", "[TarTests]") {
+    REQUIRE( rescom::json("data/config.json")["version"].asInteger() == 3 );
+}
+
+TEST_CASE("archive members not embedded", "[TarTests]") {
+    REQUIRE_FALSE( rescom::contains("LICENSE") );
+    REQUIRE_FALSE( rescom::contains("bundle.tar") );
+    REQUIRE_FALSE( rescom::contains("icons") );
+    REQUIRE( std::distance(rescom::begin(), rescom::end()) == 5 );
+}
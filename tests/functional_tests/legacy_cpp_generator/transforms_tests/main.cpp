@@ -0,0 +1,26 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+#include <rescom.hpp>
+
+#include <string>
+
+TEST_CASE("minify-json", "[TransformsTests]") {
+    REQUIRE( std::string(rescom::getText("data.json")) == "{\"name\":\"rescom\",\"values\":[1,2,3]}" );
+}
+
+TEST_CASE("transform then compile", "[TransformsTests]") {
+    REQUIRE( rescom::json("config.json")["a"].asInteger() == 1 );
+}
+
+TEST_CASE("strip-bom and eol", "[TransformsTests]") {
+    REQUIRE( std::string(rescom::getText("bom.txt")) == "line 1\nline 2\n" );
+}
+
+TEST_CASE("minify-xml", "[TransformsTests]") {
+    REQUIRE( std::string(rescom::getText("page.xml")) == "<?xml version=\"1.0\"?><page><title>Hello world!</title></page>" );
+}
+
+TEST_CASE("exec", "[TransformsTests]") {
+    REQUIRE( std::string(rescom::getText("shader.glsl")) == "#version 330\nvoid main()\n{\ngl_Position = vec4(0.0);\n}\n" );
+}
@@ -0,0 +1,41 @@
+#define CATCH_CONFIG_MAIN
+
+#include <catch2/catch_all.hpp>
+#include <rescom.hpp>
+
+TEST_CASE("variant exists", "[VariantsTests]") {
+    REQUIRE( rescom::getText("strings.txt", "en") == "Hello" );
+    REQUIRE( rescom::getText("strings.txt", "en-AU") == "Hello, mate" );
+    REQUIRE( rescom::getText("strings.txt", "fr") == "Bonjour" );
+    REQUIRE( rescom::getText("help.txt", "fr") == "Aide" );
+}
+
+TEST_CASE("variant fallback", "[VariantsTests]") {
+    REQUIRE( rescom::getText("strings.txt", "en-GB") == "Hello" );
+    REQUIRE( rescom::getText("strings.txt", "fr-CA") == "Bonjour" );
+    REQUIRE( rescom::getText("help.txt", "fr-CA") == "Aide" );
+    REQUIRE( &rescom::getResource("strings.txt", "en-GB") == &rescom::getResource("strings/en.txt") );
+}
+
+TEST_CASE("variant default", "[VariantsTests]") {
+    REQUIRE( rescom::getText("help.txt", "en-GB") == "Default help" );
+    REQUIRE( &rescom::getResource("help.txt", "de") == &rescom::getResource("help.txt") );
+}
+
+TEST_CASE("variant not found", "[VariantsTests]") {
+    REQUIRE( rescom::getResource("strings.txt", "de").key == nullptr );
+    REQUIRE( rescom::getResource("strings.txt", "es").key == nullptr );
+    REQUIRE( rescom::getResource("yolo.txt", "en").key == nullptr );
+    REQUIRE( rescom::getResource("strings/en.txt", "en").key == nullptr );
+}
+
+TEST_CASE("variant handle", "[VariantsTests]") {
+    auto const frCa = rescom::getVariant("locale", "fr-CA");
+
+    REQUIRE( frCa.valid() );
+    REQUIRE( rescom::getText("strings.txt", frCa) == "Bonjour" );
+    REQUIRE( rescom::getText("help.txt", frCa) == "Aide" );
+    REQUIRE_FALSE( rescom::getVariant("locale", "es").valid() );
+    REQUIRE_FALSE( rescom::getVariant("country", "fr").valid() );
+    REQUIRE( rescom::getResource("strings.txt", rescom::getVariant("locale", "es")).key == nullptr );
+}
@@ -0,0 +1,226 @@
+#include <Archive.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <Configuration.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+
+namespace
+{
+    std::vector<char> makeText(std::string_view text)
+    {
+        return std::vector<char>(text.begin(), text.end());
+    }
+
+    std::vector<char> loadFile(std::filesystem::path const& filePath)
+    {
+        std::ifstream file{filePath, std::ios::binary};
+
+        return std::vector<char>(std::istreambuf_iterator<char>(file), {});
+    }
+
+    ResourceSet readResources(std::vector<char> const& archive)
+    {
+        ResourceSet resources;
+
+        for (auto const& entry : readArchiveIndex(archive))
+            resources[entry.key].assign(archive.data() + entry.offset, archive.data() + entry.offset + entry.size);
+
+        return resources;
+    }
+
+    Input makeInput(std::string const& key)
+    {
+        Input input;
+
+        input.key = key;
+        input.line = 1u;
+
+        return input;
+    }
+
+    std::string_view getPayload(std::vector<char> const& archive, ArchiveEntry const& entry)
+    {
+        return std::string_view{archive.data() + entry.offset, entry.size};
+    }
+}
+
+TEST_CASE("crc32", "[ArchiveTests]") {
+    CHECK( computeCrc32(nullptr, 0u) == 0u );
+    CHECK( computeCrc32("123456789", 9u) == 0xCBF43926u );
+}
+
+TEST_CASE("empty archive", "[ArchiveTests]") {
+    auto const archive = makeArchive({});
+
+    CHECK( archive.size() == 128u );
+    CHECK( readArchiveIndex(archive).empty() );
+}
+
+TEST_CASE("archive", "[ArchiveTests]") {
+    ResourceSet const resources{{"b/second.txt", makeText("second")}, {"a.txt", makeText("first")}, {"empty", {}}};
+    auto const archive = makeArchive(resources);
+    auto const entries = readArchiveIndex(archive);
+
+    REQUIRE( entries.size() == 3u );
+    CHECK( entries[0].key == "a.txt" );
+    CHECK( entries[1].key == "b/second.txt" );
+    CHECK( entries[2].key == "empty" );
+    CHECK( getPayload(archive, entries[0]) == "first" );
+    CHECK( getPayload(archive, entries[1]) == "second" );
+    CHECK( entries[2].size == 0u );
+
+    for (auto const& entry : entries)
+        CHECK( entry.offset % 16u == 0u );
+}
+
+TEST_CASE("write archive", "[ArchiveTests]") {
+    auto const filePath = std::filesystem::temp_directory_path() / "rescom_archive_write_tests.rca";
+    ResourceSet const resources{{"a.txt", makeText("first")}, {"b.txt", std::vector<char>(1000u, 'b')}, {"empty", {}}};
+
+    writeArchive(filePath, makeResourceLoaders(resources));
+    CHECK( loadFile(filePath) == makeArchive(resources) );
+
+    // The previous archive stays if a resource can't be loaded
+    ResourceLoaders loaders;
+
+    loaders["a.txt"] = [](std::vector<char>&){ throw std::runtime_error("unable to load"); };
+    CHECK_THROWS( writeArchive(filePath, loaders) );
+    CHECK( readResources(loadFile(filePath)) == resources );
+    std::filesystem::remove(filePath);
+}
+
+TEST_CASE("invalid archive", "[ArchiveTests]") {
+    auto const archive = makeArchive({{"a.txt", makeText("first")}, {"b.txt", makeText("second")}});
+
+    CHECK_THROWS( readArchiveIndex({}) );
+    CHECK_THROWS( readArchiveIndex(std::vector<char>(archive.begin(), archive.begin() + 127)) );
+    CHECK_THROWS( readArchiveIndex(std::vector<char>(archive.begin(), archive.end() - 1)) );
+
+    // One byte changed in the header, in a payload then in the index
+    for (auto const position : {8u, 128u, static_cast<unsigned int>(archive.size() - 2u)})
+    {
+        auto corrupted = archive;
+
+        corrupted[position] ^= 0x01;
+        CHECK_THROWS( readArchiveIndex(corrupted) );
+    }
+}
+
+TEST_CASE("update archive", "[ArchiveTests]") {
+    auto const filePath = std::filesystem::temp_directory_path() / "rescom_archive_tests.rca";
+    ResourceSet resources{{"a.txt", makeText("first")}, {"b.txt", std::vector<char>(1000u, 'b')}, {"c.txt", makeText("third")}};
+
+    std::filesystem::remove(filePath);
+
+    // The archive does not exist yet
+    auto update = updateArchive(filePath, makeResourceLoaders(resources));
+
+    CHECK( update.rewritten );
+    CHECK( update.written == 3u );
+    CHECK( readResources(loadFile(filePath)) == resources );
+
+    // Nothing changed, nothing is written
+    auto const size = std::filesystem::file_size(filePath);
+
+    update = updateArchive(filePath, makeResourceLoaders(resources));
+    CHECK( !update.rewritten );
+    CHECK( update.written == 0u );
+    CHECK( update.reused == 3u );
+    CHECK( std::filesystem::file_size(filePath) == size );
+
+    // Nothing is appended if a resource can't be loaded
+    auto loaders = makeResourceLoaders(resources);
+
+    loaders["d.txt"] = [](std::vector<char>& buffer){ buffer = makeText("new"); };
+    loaders["e.txt"] = [](std::vector<char>&){ throw std::runtime_error("unable to load"); };
+    CHECK_THROWS( updateArchive(filePath, loaders) );
+    CHECK( std::filesystem::file_size(filePath) == size );
+    CHECK( readResources(loadFile(filePath)) == resources );
+
+    // Only the changed resource is appended, the other payloads stay in place
+    auto const before = readArchiveIndex(loadFile(filePath));
+
+    resources["a.txt"] = makeText("changed");
+    resources.erase("c.txt");
+    resources["d.txt"] = makeText("third");
+    update = updateArchive(filePath, makeResourceLoaders(resources));
+
+    auto const archive = loadFile(filePath);
+    auto const after = readArchiveIndex(archive);
+
+    CHECK( !update.rewritten );
+    CHECK( !update.compacted );
+    CHECK( update.written == 1u );
+    CHECK( update.reused == 2u );
+    CHECK( update.removed == 1u );
+    CHECK( update.garbageSize > 5u );
+    CHECK( archive.size() > size );
+    CHECK( readResources(archive) == resources );
+    CHECK( after[0].offset >= size );
+    CHECK( after[1].offset == before[1].offset );
+    // The renamed resource reuses the payload of the removed one
+    CHECK( after[2].offset == before[2].offset );
+    std::filesystem::remove(filePath);
+}
+
+TEST_CASE("compact archive", "[ArchiveTests]") {
+    auto const filePath = std::filesystem::temp_directory_path() / "rescom_archive_compact_tests.rca";
+    ResourceSet resources{{"a.txt", makeText("first")}, {"large", std::vector<char>(10000u, 'x')}};
+
+    std::filesystem::remove(filePath);
+    updateArchive(filePath, makeResourceLoaders(resources));
+
+    auto const size = std::filesystem::file_size(filePath);
+
+    resources["large"] = std::vector<char>(10000u, 'y');
+    auto update = updateArchive(filePath, makeResourceLoaders(resources), 90u);
+
+    CHECK( !update.compacted );
+    CHECK( std::filesystem::file_size(filePath) > size + 10000u );
+
+    resources["large"] = std::vector<char>(10000u, 'z');
+    update = updateArchive(filePath, makeResourceLoaders(resources), 50u);
+
+    CHECK( update.compacted );
+    CHECK( update.garbageSize == 0u );
+    CHECK( std::filesystem::file_size(filePath) == size );
+    CHECK( readResources(loadFile(filePath)) == resources );
+    std::filesystem::remove(filePath);
+}
+
+TEST_CASE("update invalid archive", "[ArchiveTests]") {
+    auto const filePath = std::filesystem::temp_directory_path() / "rescom_archive_invalid_tests.rca";
+    ResourceSet const resources{{"a.txt", makeText("first")}};
+
+    std::ofstream{filePath, std::ios::binary} << "not an archive";
+
+    CHECK( updateArchive(filePath, makeResourceLoaders(resources)).rewritten );
+    CHECK( readResources(loadFile(filePath)) == resources );
+    std::filesystem::remove(filePath);
+}
+
+TEST_CASE("check overlay", "[ArchiveTests]") {
+    Configuration embedded;
+    Configuration overlay;
+
+    embedded.inputs = {makeInput("a.txt"), makeInput("b.txt"), makeInput("c.txt")};
+    embedded.inputs[1].lineIndex = true;
+    embedded.inputs[2].frameSize = 64u;
+    overlay.inputs = {makeInput("a.txt")};
+    CHECK_NOTHROW( checkOverlay(overlay, embedded) );
+    CHECK_NOTHROW( checkOverlay(Configuration{}, embedded) );
+
+    overlay.inputs = {makeInput("a.txt"), makeInput("d.txt")};
+    CHECK_THROWS( checkOverlay(overlay, embedded) );
+
+    overlay.inputs = {makeInput("b.txt")};
+    CHECK_THROWS( checkOverlay(overlay, embedded) );
+
+    overlay.inputs = {makeInput("c.txt")};
+    CHECK_THROWS( checkOverlay(overlay, embedded) );
+}
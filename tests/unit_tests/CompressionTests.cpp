@@ -0,0 +1,80 @@
+#include <Compression.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <string_view>
+
+namespace
+{
+    std::vector<char> makeText(std::string_view text)
+    {
+        return std::vector<char>(text.begin(), text.end());
+    }
+
+    void checkRoundTrip(std::vector<char> const& buffer)
+    {
+        auto const frame = compressFrame(buffer.data(), buffer.size());
+
+        REQUIRE( decompressFrame(frame, buffer.size()) == buffer );
+    }
+}
+
+TEST_CASE("compress empty frame", "[CompressionTests]") {
+    auto const frame = compressFrame(nullptr, 0u);
+
+    CHECK( frame.size() == 1u );
+    CHECK( decompressFrame(frame, 0u).empty() );
+}
+
+TEST_CASE("compress frame", "[CompressionTests]") {
+    checkRoundTrip(makeText("a"));
+    checkRoundTrip(makeText("abcd"));
+    checkRoundTrip(makeText("hello hello hello hello"));
+    checkRoundTrip(std::vector<char>(1000u, 'x'));
+    checkRoundTrip(makeText("0123456789abcdefghijklmnopqrstuvwxyz"));
+}
+
+TEST_CASE("compress frame long lengths", "[CompressionTests]") {
+    std::vector<char> buffer;
+    unsigned int seed = 42u;
+
+    // 600 pseudo-random bytes (long literals), then a long repetition (long match)
+    for (auto i = 0u; i < 600u; ++i)
+    {
+        seed = seed * 1103515245u + 12345u;
+        buffer.push_back(static_cast<char>(seed >> 16u));
+    }
+    buffer.insert(buffer.end(), buffer.begin(), buffer.begin() + 600);
+
+    auto const frame = compressFrame(buffer.data(), buffer.size());
+
+    CHECK( frame.size() < 700u );
+    CHECK( decompressFrame(frame, buffer.size()) == buffer );
+}
+
+TEST_CASE("compress frames", "[CompressionTests]") {
+    std::vector<char> buffer;
+
+    for (auto i = 0u; i < 1000u; ++i)
+        buffer.push_back(static_cast<char>('a' + i % 7u));
+
+    auto const frames = compressFrames(buffer, 256u);
+
+    REQUIRE( frames.offsets.size() == 5u );
+    CHECK( frames.offsets.front() == 0u );
+    CHECK( frames.offsets.back() == frames.data.size() );
+
+    // Each frame is decodable alone
+    for (auto i = 0u; i + 1u < frames.offsets.size(); ++i)
+    {
+        std::vector<char> const frame(frames.data.begin() + frames.offsets[i], frames.data.begin() + frames.offsets[i + 1u]);
+        auto const size = i < 3u ? 256u : 232u;
+
+        CHECK( decompressFrame(frame, size) == std::vector<char>(buffer.begin() + i * 256u, buffer.begin() + i * 256u + size) );
+    }
+}
+
+TEST_CASE("decompress invalid frame", "[CompressionTests]") {
+    CHECK_THROWS( decompressFrame(makeText("\xF0"), 15u) );
+    CHECK_THROWS( decompressFrame(makeText("\x10" "a\x05\x00"), 5u) );
+    CHECK_THROWS( decompressFrame(makeText("\x20" "ab"), 3u) );
+}
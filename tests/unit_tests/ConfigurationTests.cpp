@@ -70,3 +70,149 @@ TEST_CASE("two line", "ConfigurationTests") {
     CHECK( c.inputs[1].line == 2 );
 }
 
+
+TEST_CASE("options", "ConfigurationTests") {
+    auto c = parse("a.res | lines\nb.res|lines # comment\na ab.res");
+
+    REQUIRE( c.inputs.size() == 3 );
+    CHECK( c.inputs[0].key == "a ab.res" );
+    CHECK( !c.inputs[0].lineIndex );
+    CHECK( c.inputs[1].key == "a.res" );
+    CHECK( c.inputs[1].lineIndex );
+    CHECK( c.inputs[2].key == "b.res" );
+    CHECK( c.inputs[2].lineIndex );
+}
+
+TEST_CASE("invalid options", "ConfigurationTests") {
+    CHECK_THROWS( parse("a.res | yolo") );
+    CHECK_THROWS( parse("a.res | lines=12") );
+}
+
+TEST_CASE("csv option", "ConfigurationTests") {
+    auto c = parse("a.res | csv=float,int16");
+
+    REQUIRE( c.inputs.size() == 1 );
+    CHECK( c.inputs[0].columnTypes == std::vector<ColumnType>{ColumnType::Float, ColumnType::Int16} );
+    CHECK( !c.inputs[0].tableHeader );
+    CHECK( parse("a.res | csv=header,float").inputs[0].tableHeader );
+    CHECK( parse("a.res | csv=header,float").inputs[0].columnTypes == std::vector<ColumnType>{ColumnType::Float} );
+    CHECK_THROWS( parse("a.res | csv=float,yolo") );
+    CHECK_THROWS( parse("a.res | csv") );
+    CHECK_THROWS( parse("a.res | csv=header") );
+    CHECK_THROWS( parse("a.res | csv=float,header") );
+}
+
+TEST_CASE("json option", "ConfigurationTests") {
+    auto c = parse("a.res | json");
+
+    REQUIRE( c.inputs.size() == 1 );
+    CHECK( c.inputs[0].json );
+    CHECK_THROWS( parse("a.res | json=yes") );
+}
+
+TEST_CASE("dictionary options", "ConfigurationTests") {
+    auto c = parse("a.res | map\nb.res | set");
+
+    REQUIRE( c.inputs.size() == 2 );
+    CHECK( c.inputs[0].dictionaryType == DictionaryType::Map );
+    CHECK( c.inputs[1].dictionaryType == DictionaryType::Set );
+    CHECK_THROWS( parse("a.res | set=1") );
+}
+
+TEST_CASE("compress option", "ConfigurationTests") {
+    CHECK( parse("a.res").inputs[0].frameSize == 0u );
+    CHECK( parse("a.res | compress").inputs[0].frameSize == 64u * 1024u );
+    CHECK( parse("a.res | compress=4096").inputs[0].frameSize == 4096u );
+    CHECK( parse("a.res | compress=16k").inputs[0].frameSize == 16u * 1024u );
+    CHECK_THROWS( parse("a.res | compress=0") );
+    CHECK_THROWS( parse("a.res | compress=big") );
+    CHECK_THROWS( parse("a.res | compress=1000000k") );
+    CHECK_THROWS( parse("a.res | compress lines") );
+    CHECK_THROWS( parse("a.res | json compress") );
+}
+
+TEST_CASE("transform options", "ConfigurationTests") {
+    auto c = parse("a.res | strip-bom exec=\"cmake -E copy {input} {output}\" eol=lf");
+
+    REQUIRE( c.inputs.size() == 1 );
+    REQUIRE( c.inputs[0].transforms.size() == 3 );
+    CHECK( c.inputs[0].transforms[1]->identity() == "exec=cmake -E copy {input} {output}" );
+    CHECK_THROWS( parse("a.res | eol=yolo") );
+    CHECK_THROWS( parse("a.res | exec=\"cmake") );
+}
+
+TEST_CASE("options directive", "ConfigurationTests") {
+    auto c = parse("@options *.res | strip-bom\n@options b.* | lines\na.res | eol=lf\nb.res");
+
+    REQUIRE( c.inputs.size() == 2 );
+    REQUIRE( c.inputs[0].transforms.size() == 2 );
+    CHECK( c.inputs[0].transforms[0]->identity() == "strip-bom" );
+    CHECK( c.inputs[0].transforms[1]->identity() == "eol=lf" );
+    CHECK( !c.inputs[0].lineIndex );
+    CHECK( c.inputs[1].transforms.size() == 1 );
+    CHECK( c.inputs[1].lineIndex );
+    CHECK_THROWS( parse("@options | lines") );
+}
+
+TEST_CASE("variants directives", "ConfigurationTests") {
+    auto c = parse("@dimension locale | en fr en-GB>en fr-CA>fr\n@variants z.res = {locale}/z.res\n@variants a.res = {locale}.res\na.res");
+
+    REQUIRE( c.dimensions.size() == 1 );
+    CHECK( c.dimensions[0].name == "locale" );
+    REQUIRE( c.dimensions[0].values == std::vector<std::string>{"en", "fr", "en-GB", "fr-CA"} );
+    CHECK( !c.dimensions[0].fallbacks[0].has_value() );
+    CHECK( !c.dimensions[0].fallbacks[1].has_value() );
+    CHECK( c.dimensions[0].fallbacks[2] == 0u );
+    CHECK( c.dimensions[0].fallbacks[3] == 1u );
+    REQUIRE( c.variantGroups.size() == 2 );
+    CHECK( c.variantGroups[0].key == "a.res" );
+    CHECK( c.variantGroups[0].pattern == "{locale}.res" );
+    CHECK( c.variantGroups[1].key == "z.res" );
+    CHECK( c.variantGroups[1].dimension == 0u );
+}
+
+TEST_CASE("invalid variants directives", "ConfigurationTests") {
+    CHECK_THROWS( parse("@dimension | en fr") );
+    CHECK_THROWS( parse("@dimension locale") );
+    CHECK_THROWS( parse("@dimension locale | en en") );
+    CHECK_THROWS( parse("@dimension locale | en-GB>de") );
+    CHECK_THROWS( parse("@dimension locale | en>fr fr>en") );
+    CHECK_THROWS( parse("@dimension locale | en\n@dimension locale | fr") );
+    CHECK_THROWS( parse("@dimension locale | en\n@variants a.res") );
+    CHECK_THROWS( parse("@dimension locale | en\n@variants a.res = a.res") );
+    CHECK_THROWS( parse("@dimension locale | en\n@variants a.res = {country}.res") );
+    CHECK_THROWS( parse("@dimension locale | en\n@variants a.res = {locale}.res\n@variants a.res = {locale}.txt") );
+}
+
+TEST_CASE("cached directive", "ConfigurationTests") {
+    CHECK( !parse("a.res").runtimeCacheBudget.has_value() );
+    CHECK( parse("@cached\na.res").runtimeCacheBudget == 64u * 1024u * 1024u );
+    CHECK( parse("@cached 512k").runtimeCacheBudget == 512u * 1024u );
+    CHECK( parse("@cached 2M").runtimeCacheBudget == 2u * 1024u * 1024u );
+    CHECK( parse("@cached 1000").runtimeCacheBudget == 1000u );
+    CHECK_THROWS( parse("@cached lots") );
+    CHECK_THROWS( parse("@cached 12G") );
+}
+
+TEST_CASE("inline directive", "ConfigurationTests") {
+    CHECK( parse("a.res").inlineThreshold == 0u );
+    CHECK( parse("@inline\na.res").inlineThreshold == 16u );
+    CHECK( parse("@inline 24").inlineThreshold == 24u );
+    CHECK_THROWS( parse("@inline 0") );
+    CHECK_THROWS( parse("@inline 65") );
+    CHECK_THROWS( parse("@inline tiny") );
+}
+
+TEST_CASE("archive directive", "ConfigurationTests") {
+    CHECK( !parse("a.res").externalArchive );
+    CHECK( parse("@archive\na.res").externalArchive );
+    CHECK( parse("@archive # comment").externalArchive );
+    CHECK_THROWS( parse("@archive a.res") );
+}
+
+TEST_CASE("overlay directive", "ConfigurationTests") {
+    CHECK( !parse("a.res").overlayPath.has_value() );
+    CHECK( parse("@overlay hotfix.rca\na.res").overlayPath == "hotfix.rca" );
+    CHECK( parse("@overlay /opt/app/hotfix.rca # comment").overlayPath == "/opt/app/hotfix.rca" );
+    CHECK_THROWS( parse("@overlay") );
+}
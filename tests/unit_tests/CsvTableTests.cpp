@@ -0,0 +1,58 @@
+#include <CsvTable.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <string_view>
+
+namespace
+{
+    std::vector<CsvColumn> parseTable(std::string_view text, std::vector<ColumnType> const& types, bool hasHeader = false)
+    {
+        return parseCsvTable(std::vector<char>(text.begin(), text.end()), types, hasHeader);
+    }
+}
+
+TEST_CASE("column types", "CsvTableTests") {
+    CHECK( toColumnType("float") == ColumnType::Float );
+    CHECK( toColumnType("uint16") == ColumnType::UInt16 );
+    CHECK( !toColumnType("int128").has_value() );
+    CHECK( toCppType(ColumnType::Int64) == "std::int64_t" );
+}
+
+TEST_CASE("without header", "CsvTableTests") {
+    auto const columns = parseTable("1, 2\n\n-3,+4\n", {ColumnType::Int8, ColumnType::UInt32});
+
+    REQUIRE( columns.size() == 2u );
+    CHECK( columns[0].name.empty() );
+    CHECK( columns[0].values == std::vector<std::string>{"1", "-3"} );
+    CHECK( columns[1].values == std::vector<std::string>{"2u", "4u"} );
+}
+
+TEST_CASE("with header", "CsvTableTests") {
+    auto const columns = parseTable("x,\"y\"\r\n0.5,2\r\n", {ColumnType::Float, ColumnType::Double}, true);
+
+    REQUIRE( columns.size() == 2u );
+    CHECK( columns[0].name == "x" );
+    CHECK( columns[1].name == "y" );
+    CHECK( columns[0].values == std::vector<std::string>{"0x1p-1f"} );
+    CHECK( columns[1].values == std::vector<std::string>{"0x1p+1"} );
+}
+
+TEST_CASE("header not declared", "CsvTableTests") {
+    // A header must be declared, otherwise its line is an invalid row
+    CHECK_THROWS( parseTable("x,y\n0.5,2\n", {ColumnType::Float, ColumnType::Double}) );
+    CHECK_THROWS( parseTable("0.5,yolo\n1,2\n", {ColumnType::Float, ColumnType::Double}) );
+    CHECK( parseTable("1,2\n3,4\n", {ColumnType::Int8, ColumnType::Int8}, true)[0].name == "1" );
+    CHECK( parseTable("1,2\n3,4\n", {ColumnType::Int8, ColumnType::Int8}, true)[0].values == std::vector<std::string>{"3"} );
+}
+
+TEST_CASE("integer limits", "CsvTableTests") {
+    CHECK( parseTable("-9223372036854775808", {ColumnType::Int64})[0].values.front() == "(-9223372036854775807 - 1)" );
+    CHECK_THROWS( parseTable("1\n128", {ColumnType::Int8}) );
+    CHECK_THROWS( parseTable("1\n-1", {ColumnType::UInt8}) );
+}
+
+TEST_CASE("invalid tables", "CsvTableTests") {
+    CHECK_THROWS( parseTable("1,2\n3", {ColumnType::Int32, ColumnType::Int32}) );
+    CHECK_THROWS( parseTable("1\nabc", {ColumnType::Double}) );
+    CHECK_THROWS( parseTable("1\ninf", {ColumnType::Double}) );
+}
@@ -0,0 +1,138 @@
+#include <Delta.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <filesystem>
+#include <string_view>
+
+namespace
+{
+    std::vector<char> makeText(std::string_view text)
+    {
+        return std::vector<char>(text.begin(), text.end());
+    }
+
+    std::vector<char> makeRandomContent(std::size_t size, unsigned int seed)
+    {
+        std::vector<char> buffer;
+
+        for (auto i = 0u; i < size; ++i)
+        {
+            seed = seed * 1103515245u + 12345u;
+            buffer.push_back(static_cast<char>(seed >> 16u));
+        }
+
+        return buffer;
+    }
+
+    void checkRoundTrip(ResourceSet const& oldResources, ResourceSet const& newResources)
+    {
+        auto const patch = makeDelta(oldResources, newResources);
+
+        REQUIRE( applyDelta(oldResources, patch) == newResources );
+    }
+}
+
+TEST_CASE("delta of unchanged resources", "[DeltaTests]") {
+    ResourceSet const resources{{"a", makeRandomContent(100000u, 1u)}, {"b", makeText("hello")}};
+    auto const patch = makeDelta(resources, resources);
+
+    CHECK( patch.size() < 64u );
+    CHECK( applyDelta(resources, patch) == resources );
+}
+
+TEST_CASE("delta of empty resources", "[DeltaTests]") {
+    checkRoundTrip({}, {});
+    checkRoundTrip({}, {{"a", makeText("hello")}});
+    checkRoundTrip({{"a", makeText("hello")}}, {});
+    checkRoundTrip({{"a", makeText("hello")}}, {{"a", {}}});
+    checkRoundTrip({{"a", {}}}, {{"a", makeText("hello")}});
+}
+
+TEST_CASE("delta of a small change in a large resource", "[DeltaTests]") {
+    auto const content = makeRandomContent(200000u, 2u);
+    auto changed = content;
+
+    changed[1000u] ^= 0x55;
+    changed.insert(changed.begin() + 50000, 'x');
+    changed.erase(changed.begin() + 150000, changed.begin() + 150100);
+
+    ResourceSet const oldResources{{"data", content}};
+    ResourceSet const newResources{{"data", changed}};
+    auto const patch = makeDelta(oldResources, newResources);
+
+    CHECK( patch.size() < 4096u );
+    CHECK( applyDelta(oldResources, patch) == newResources );
+}
+
+TEST_CASE("delta of appended content", "[DeltaTests]") {
+    auto const content = makeRandomContent(10000u, 3u);
+    auto changed = content;
+    auto const suffix = makeText("appended");
+
+    changed.insert(changed.end(), suffix.begin(), suffix.end());
+    changed.insert(changed.begin(), suffix.begin(), suffix.end());
+    checkRoundTrip({{"data", content}}, {{"data", changed}});
+}
+
+TEST_CASE("delta of added, removed and renamed resources", "[DeltaTests]") {
+    auto const content = makeRandomContent(50000u, 4u);
+    ResourceSet const oldResources{{"old/name", content}, {"removed", makeText("removed")}, {"kept", makeText("kept")}};
+    ResourceSet const newResources{{"new/name", content}, {"added", makeText("added")}, {"kept", makeText("kept")}};
+    auto const patch = makeDelta(oldResources, newResources);
+
+    // The renamed resource is copied, not stored again
+    CHECK( patch.size() < 256u );
+    CHECK( applyDelta(oldResources, patch) == newResources );
+}
+
+TEST_CASE("delta applied to other resources", "[DeltaTests]") {
+    ResourceSet const oldResources{{"a", makeText("hello")}};
+    auto const patch = makeDelta(oldResources, {{"a", makeText("world")}});
+
+    CHECK_THROWS( applyDelta({{"a", makeText("hallo")}}, patch) );
+    CHECK_THROWS( applyDelta({}, patch) );
+}
+
+TEST_CASE("invalid delta", "[DeltaTests]") {
+    ResourceSet const oldResources{{"a", makeRandomContent(10000u, 5u)}};
+    auto changed = oldResources.at("a");
+
+    changed[5000u] ^= 0x01;
+
+    auto const patch = makeDelta(oldResources, {{"a", changed}});
+
+    CHECK_THROWS( applyDelta(oldResources, {}) );
+    CHECK_THROWS( applyDelta(oldResources, makeText("RSCD")) );
+
+    for (auto const size : {5u, 37u, 40u, static_cast<unsigned int>(patch.size() - 1u)})
+        CHECK_THROWS( applyDelta(oldResources, std::vector<char>(patch.begin(), patch.begin() + size)) );
+
+    auto corrupted = patch;
+
+    corrupted[patch.size() - 40u] ^= 0x01;
+    CHECK_THROWS( applyDelta(oldResources, corrupted) );
+
+    auto extended = patch;
+
+    extended.push_back(0);
+    CHECK_THROWS( applyDelta(oldResources, extended) );
+}
+
+TEST_CASE("write resources", "[DeltaTests]") {
+    auto const directory = std::filesystem::temp_directory_path() / "rescom_delta_tests_output";
+
+    std::filesystem::remove_all(directory);
+    writeResourceSet({{"a.txt", makeText("a")}, {"b/..c/d.txt", makeText("d")}}, directory);
+
+    CHECK( std::filesystem::file_size(directory / "a.txt") == 1u );
+    CHECK( std::filesystem::file_size(directory / "b/..c/d.txt") == 1u );
+
+    for (auto const* key : {"", "..", "../rescom_delta_tests_escaped.txt", "b/../../a.txt", "b/..", "/tmp/a.txt", "b\\..\\..\\a.txt", "C:a.txt"})
+    {
+        CHECK_FALSE( isContainedKey(key) );
+        CHECK_THROWS( writeResourceSet({{key, makeText("a")}}, directory) );
+    }
+    CHECK_FALSE( std::filesystem::exists(directory.parent_path() / "rescom_delta_tests_escaped.txt") );
+
+    std::filesystem::remove_all(directory);
+}
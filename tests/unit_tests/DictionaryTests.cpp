@@ -0,0 +1,75 @@
+#include <Dictionary.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <set>
+#include <string_view>
+
+namespace
+{
+    std::vector<char> makeText(std::string_view text)
+    {
+        return std::vector<char>(text.begin(), text.end());
+    }
+
+    void checkTable(std::vector<DictionaryEntry> const& entries)
+    {
+        auto const table = buildPerfectHashTable(entries);
+        std::set<int> found;
+
+        REQUIRE( table.slots.size() >= entries.size() );
+
+        for (auto i = 0u; i < entries.size(); ++i)
+        {
+            auto const& key = entries[i].key;
+            auto const seed = table.seeds[hashKey(key, 0u) % table.seeds.size()];
+
+            CHECK( table.slots[hashKey(key, seed) % table.slots.size()] == static_cast<int>(i) );
+            found.insert(static_cast<int>(i));
+        }
+
+        CHECK( found.size() == entries.size() );
+        CHECK( std::count(table.slots.begin(), table.slots.end(), -1) == static_cast<long>(table.slots.size() - entries.size()) );
+    }
+}
+
+TEST_CASE("key values", "DictionaryTests") {
+    auto const entries = parseKeyValues(makeText("# comment\n hello = bonjour \n\nbye=au revoir=\\n\\\\\n"));
+
+    REQUIRE( entries.size() == 2u );
+    CHECK( entries[0].key == "hello" );
+    CHECK( entries[0].value == "bonjour" );
+    CHECK( entries[1].key == "bye" );
+    CHECK( entries[1].value == "au revoir=\n\\" );
+}
+
+TEST_CASE("invalid key values", "DictionaryTests") {
+    CHECK_THROWS( parseKeyValues(makeText("a=1\nb")) );
+    CHECK_THROWS( parseKeyValues(makeText("=1")) );
+    CHECK_THROWS( parseKeyValues(makeText("a=1\na=2")) );
+    CHECK_THROWS( parseKeyValues(makeText("a=\\x")) );
+}
+
+TEST_CASE("words", "DictionaryTests") {
+    auto const entries = parseWords(makeText("the\r\n a\n#an\nthe\n"));
+
+    REQUIRE( entries.size() == 2u );
+    CHECK( entries[0].key == "the" );
+    CHECK( entries[1].key == "a" );
+}
+
+TEST_CASE("perfect hash table", "DictionaryTests") {
+    std::vector<DictionaryEntry> entries;
+
+    checkTable(entries);
+
+    for (auto i = 0u; i < 5000u; ++i)
+    {
+        entries.push_back(DictionaryEntry{"key" + std::to_string(i), {}});
+
+        if (i < 20u || i % 499u == 0u)
+            checkTable(entries);
+    }
+
+    checkTable(entries);
+}
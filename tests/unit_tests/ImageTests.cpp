@@ -0,0 +1,201 @@
+#include <Image.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <Archive.hpp>
+#include <Transform.hpp>
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    void writeBigEndian(std::vector<char>& buffer, std::uint32_t value)
+    {
+        for (auto shift = 24; shift >= 0; shift -= 8)
+            buffer.push_back(static_cast<char>((value >> shift) & 0xFFu));
+    }
+
+    void writeChunk(std::vector<char>& file, std::string const& type, std::vector<char> const& data)
+    {
+        std::vector<char> chunk(type.begin(), type.end());
+
+        chunk.insert(chunk.end(), data.begin(), data.end());
+        writeBigEndian(file, static_cast<std::uint32_t>(data.size()));
+        file.insert(file.end(), chunk.begin(), chunk.end());
+        writeBigEndian(file, computeCrc32(chunk.data(), chunk.size()));
+    }
+
+    /// zlib stream made of a single stored block.
+    std::vector<char> store(std::vector<unsigned char> const& data)
+    {
+        std::vector<char> stream = {0x78, 0x01, 0x01,
+                                    static_cast<char>(data.size() & 0xFFu), static_cast<char>(data.size() >> 8u),
+                                    static_cast<char>(~data.size() & 0xFFu), static_cast<char>((~data.size() >> 8u) & 0xFFu)};
+        std::uint32_t a = 1u;
+        std::uint32_t b = 0u;
+
+        for (auto const byte : data)
+        {
+            stream.push_back(static_cast<char>(byte));
+            a = (a + byte) % 65521u;
+            b = (b + a) % 65521u;
+        }
+        writeBigEndian(stream, (b << 16u) | a);
+
+        return stream;
+    }
+
+    /// PNG file whose image data are the scanlines 'data', filter types included.
+    std::vector<char> makePng(std::uint32_t width, std::uint32_t height, unsigned char bitDepth, unsigned char colorType,
+                              std::vector<unsigned char> const& data, std::vector<std::pair<std::string, std::vector<char>>> const& chunks = {},
+                              bool interlaced = false)
+    {
+        std::vector<char> file = {'\x89', 'P', 'N', 'G', '\r', '\n', '\x1A', '\n'};
+        std::vector<char> header;
+
+        writeBigEndian(header, width);
+        writeBigEndian(header, height);
+        header.insert(header.end(), {static_cast<char>(bitDepth), static_cast<char>(colorType), 0, 0, static_cast<char>(interlaced ? 1 : 0)});
+        writeChunk(file, "IHDR", header);
+
+        for (auto const& [type, chunk] : chunks)
+            writeChunk(file, type, chunk);
+
+        writeChunk(file, "IDAT", store(data));
+        writeChunk(file, "IEND", {});
+
+        return file;
+    }
+
+    std::vector<unsigned char> inflate(std::vector<unsigned char> const& stream, std::size_t maxSize = 1u << 20u)
+    {
+        return ::inflate(stream.data(), stream.size(), maxSize);
+    }
+}
+
+TEST_CASE("inflate", "[ImageTests]") {
+    std::string const hello = "hello hello hello hello";
+    std::vector<unsigned char> const fixed = {0x78, 0xDA, 0xCB, 0x48, 0xCD, 0xC9, 0xC9, 0x57, 0xC8, 0x40, 0x27, 0x01, 0x68, 0x03, 0x08, 0xB1};
+    std::vector<unsigned char> const dynamic = {
+        0x78, 0xDA, 0xED, 0x92, 0xC7, 0x0D, 0x80, 0x30, 0x10, 0x04, 0xFF, 0x54, 0x71, 0x25, 0x90, 0x53, 0x37, 0x04, 0x03, 0x06,
+        0x63, 0x93, 0x4C, 0xAA, 0x1E, 0x41, 0x09, 0xFB, 0xE1, 0x73, 0xEF, 0xD5, 0x68, 0xA5, 0xD1, 0x28, 0xA9, 0x05, 0xB9, 0x39,
+        0x6D, 0x9D, 0xA0, 0xD9, 0xCA, 0x6A, 0xA0, 0x72, 0x31, 0x87, 0xA6, 0xC6, 0x9C, 0xD4, 0xDB, 0x71, 0x5A, 0xC9, 0xEC, 0x62,
+        0xF9, 0x66, 0x55, 0xDC, 0x17, 0xD5, 0xA6, 0x75, 0xD4, 0xCB, 0x24, 0x00, 0xE3, 0x01, 0x4C, 0x0A, 0x30, 0x3E, 0xC0, 0x64,
+        0x00, 0x13, 0x20, 0x0E, 0x10, 0xD9, 0x21, 0x72, 0x84, 0xD8, 0x8E, 0x90, 0x23, 0x44, 0x77, 0x0C, 0x30, 0x9C, 0x29, 0x67,
+        0xCA, 0x99, 0x72, 0xA6, 0x9C, 0xE9, 0x0F, 0x99, 0x3E, 0xB1, 0x40, 0xDF, 0xB0};
+    std::string text;
+
+    for (auto i = 0u; i < 40u; ++i)
+        text += "line " + std::to_string(i * 7u % 13u) + ": the quick brown fox jumps over the lazy dog\n";
+
+    auto const stored = store({'a', 'b', 'c'});
+
+    CHECK( inflate(std::vector<unsigned char>(stored.begin(), stored.end())) == std::vector<unsigned char>{'a', 'b', 'c'} );
+    CHECK( inflate(fixed) == std::vector<unsigned char>(hello.begin(), hello.end()) );
+    CHECK( inflate(dynamic) == std::vector<unsigned char>(text.begin(), text.end()) );
+
+    auto corrupted = dynamic;
+
+    corrupted.back() ^= 1u;
+    CHECK_THROWS( inflate(corrupted) );
+    CHECK_THROWS( inflate(std::vector<unsigned char>(dynamic.begin(), dynamic.end() - 20)) );
+    CHECK_THROWS( inflate(dynamic, 100u) );
+    CHECK_THROWS( inflate({0x78, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x01}) );
+}
+
+TEST_CASE("png color types", "[ImageTests]") {
+    // Gray on 8 bits, with the filters Sub then Up
+    auto const gray = decodePng(makePng(2u, 2u, 8u, 0u, {1, 10, 5, 2, 1, 1}));
+
+    CHECK( gray.width == 2u );
+    CHECK( gray.height == 2u );
+    CHECK( gray.pixels == std::vector<unsigned char>{10, 10, 10, 255, 15, 15, 15, 255, 11, 11, 11, 255, 16, 16, 16, 255} );
+
+    // Gray on 1 bit, scaled to 8 bits
+    CHECK( decodePng(makePng(3u, 1u, 1u, 0u, {0, 0xA0})).pixels == std::vector<unsigned char>{255, 255, 255, 255, 0, 0, 0, 255, 255, 255, 255, 255} );
+
+    // RGB with a transparent color, with the filter Paeth
+    auto const rgb = decodePng(makePng(2u, 1u, 8u, 2u, {4, 1, 2, 3, 1, 1, 1}, {{"tRNS", {0, 2, 0, 3, 0, 4}}}));
+
+    CHECK( rgb.pixels == std::vector<unsigned char>{1, 2, 3, 255, 2, 3, 4, 0} );
+
+    // Palette on 2 bits with transparency of the first entry, and the filter Average
+    auto const palette = decodePng(makePng(2u, 1u, 2u, 3u, {3, 0x40}, {{"PLTE", {10, 20, 30, 40, 50, 60}}, {"tRNS", {'\x80'}}}));
+
+    CHECK( palette.pixels == std::vector<unsigned char>{40, 50, 60, 255, 10, 20, 30, 128} );
+
+    // Gray and alpha on 16 bits, the least significant bytes are dropped
+    CHECK( decodePng(makePng(1u, 1u, 16u, 4u, {0, 0x12, 0x34, 0x56, 0x78})).pixels == std::vector<unsigned char>{0x12, 0x12, 0x12, 0x56} );
+
+    // RGBA on 8 bits
+    CHECK( decodePng(makePng(1u, 1u, 8u, 6u, {0, 1, 2, 3, 4})).pixels == std::vector<unsigned char>{1, 2, 3, 4} );
+}
+
+TEST_CASE("png interlaced", "[ImageTests]") {
+    // Passes of a 3x3 image, each pixel is 10 * y + x
+    auto const image = decodePng(makePng(3u, 3u, 8u, 0u, {0, 0,  0, 2,  0, 20, 22,  0, 1,  0, 21,  0, 10, 11, 12}, {}, true));
+    std::vector<unsigned char> expected;
+
+    for (unsigned char y = 0u; y < 3u; ++y)
+    {
+        for (unsigned char x = 0u; x < 3u; ++x)
+            expected.insert(expected.end(), {static_cast<unsigned char>(10u * y + x), static_cast<unsigned char>(10u * y + x), static_cast<unsigned char>(10u * y + x), 255u});
+    }
+
+    CHECK( image.pixels == expected );
+}
+
+TEST_CASE("invalid png", "[ImageTests]") {
+    auto const valid = makePng(1u, 1u, 8u, 0u, {0, 0});
+    auto corrupted = valid;
+
+    corrupted[20] ^= 1;
+    CHECK_THROWS( decodePng(std::vector<char>(valid.begin() + 1, valid.end())) );
+    CHECK_THROWS( decodePng(corrupted) );
+    CHECK_THROWS( decodePng(std::vector<char>(valid.begin(), valid.end() - 12)) );
+    CHECK_THROWS( decodePng(makePng(1u, 1u, 8u, 0u, {0})) );
+    CHECK_THROWS( decodePng(makePng(1u, 1u, 8u, 0u, {5, 0})) );
+    CHECK_THROWS( decodePng(makePng(1u, 1u, 8u, 3u, {0, 0})) );
+    CHECK_THROWS( decodePng(makePng(1u, 1u, 8u, 3u, {0, 1}, {{"PLTE", {1, 2, 3}}})) );
+    CHECK_THROWS( decodePng(makePng(1u, 1u, 4u, 2u, {0, 0})) );
+    CHECK_THROWS( decodePng(makePng(0u, 1u, 8u, 0u, {})) );
+    CHECK_THROWS( decodePng(makePng(1u, 1u, 8u, 0u, {0, 0}, {{"ABCD", {}}})) );
+    CHECK_NOTHROW( decodePng(makePng(1u, 1u, 8u, 0u, {0, 0}, {{"tEXt", {'a', '\0', 'b'}}})) );
+}
+
+TEST_CASE("encode image", "[ImageTests]") {
+    DecodedImage const image{3u, 2u, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24}};
+    auto const rgba = encodeImage(image, PixelFormat::Rgba8, 1u);
+    auto const r8 = encodeImage(image, PixelFormat::R8, 4u);
+
+    CHECK( std::string(rgba.begin(), rgba.begin() + 16) == std::string("RSCI\x03\0\0\0\x02\0\0\0\x04\0\x01\0", 16u) );
+    CHECK( std::vector<char>(rgba.begin() + 16, rgba.end()) == std::vector<char>(image.pixels.begin(), image.pixels.end()) );
+    CHECK( std::string(r8.begin(), r8.begin() + 16) == std::string("RSCI\x03\0\0\0\x02\0\0\0\x01\0\x04\0", 16u) );
+    CHECK( std::vector<char>(r8.begin() + 16, r8.end()) == std::vector<char>{1, 5, 9, 0, 13, 17, 21, 0} );
+
+    // The header is padded to the alignment of the rows
+    auto const aligned = encodeImage(image, PixelFormat::R8, 32u);
+
+    CHECK( aligned.size() == 32u + 2u * 32u );
+    CHECK( aligned[14] == 32 );
+    CHECK( std::vector<char>(aligned.begin() + 16, aligned.begin() + 32) == std::vector<char>(16u, '\0') );
+    CHECK( aligned[32] == 1 );
+    CHECK( aligned[64] == 13 );
+}
+
+TEST_CASE("png", "[ImageTests]") {
+    std::vector<char> buffer = makePng(1u, 1u, 8u, 2u, {0, 7, 8, 9});
+
+    applyTransforms({instanciateTransform("png", "r8,2")}, buffer, std::nullopt);
+
+    CHECK( buffer.size() == 18u );
+    CHECK( buffer[16] == 7 );
+    CHECK( instanciateTransform("png", "")->identity() == "png=rgba8,1" );
+    CHECK( instanciateTransform("png", "r8")->identity() == "png=r8,1" );
+    CHECK_THROWS( instanciateTransform("png", "rgb8") );
+    CHECK_THROWS( instanciateTransform("png", "r8,3") );
+    CHECK_THROWS( instanciateTransform("png", "r8,512") );
+    CHECK_THROWS( instanciateTransform("png", "r8,") );
+}
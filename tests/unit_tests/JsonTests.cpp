@@ -0,0 +1,42 @@
+#include <Json.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <string_view>
+
+namespace
+{
+    std::vector<char> compile(std::string_view text)
+    {
+        return compileJson(std::vector<char>(text.begin(), text.end()));
+    }
+}
+
+TEST_CASE("scalars", "JsonTests") {
+    CHECK( compile("null") == std::vector<char>{4, 0, 0, 0, JsonTape::Null} );
+    CHECK( compile(" true ") == std::vector<char>{4, 0, 0, 0, JsonTape::True} );
+    CHECK( compile("false") == std::vector<char>{4, 0, 0, 0, JsonTape::False} );
+    CHECK( compile("-2") == std::vector<char>{4, 0, 0, 0, JsonTape::Integer, -2, -1, -1, -1, -1, -1, -1, -1} );
+    CHECK( compile("\"a\"") == std::vector<char>{4, 0, 0, 0, JsonTape::String, 1, 0, 0, 0, 'a', 0} );
+}
+
+TEST_CASE("containers", "JsonTests") {
+    // The key and the value are written before the object.
+    CHECK( compile("{\"a\": null}") == std::vector<char>{12, 0, 0, 0, JsonTape::String, 1, 0, 0, 0, 'a', 0, JsonTape::Null,
+                                                         JsonTape::Object, 1, 0, 0, 0, 4, 0, 0, 0, 11, 0, 0, 0} );
+    CHECK( compile("[]") == std::vector<char>{4, 0, 0, 0, JsonTape::Array, 0, 0, 0, 0} );
+    CHECK_NOTHROW( compile("[1, 2.5e3, -0.5, {\"b\": [true, false], \"a\": {}}, \"\\u00e9\\ud83d\\ude00\"]") );
+}
+
+TEST_CASE("invalid documents", "JsonTests") {
+    CHECK_THROWS( compile("") );
+    CHECK_THROWS( compile("[1, 2") );
+    CHECK_THROWS( compile("[1, 2,]") );
+    CHECK_THROWS( compile("{\"a\": 1, \"a\": 2}") );
+    CHECK_THROWS( compile("{a: 1}") );
+    CHECK_THROWS( compile("01") );
+    CHECK_THROWS( compile("1e999") );
+    CHECK_THROWS( compile("\"\\x\"") );
+    CHECK_THROWS( compile("\"\\ud83d\"") );
+    CHECK_THROWS( compile("nul") );
+    CHECK_THROWS( compile("1 2") );
+}
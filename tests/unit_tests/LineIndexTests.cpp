@@ -0,0 +1,58 @@
+#include <LineIndex.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <string_view>
+
+namespace
+{
+    LineIndex build(std::string_view text)
+    {
+        return buildLineIndex(std::vector<char>(text.begin(), text.end()));
+    }
+
+    std::string_view getLine(std::string_view text, LineIndex const& index, std::uint32_t line)
+    {
+        auto const begin = index.offset(line);
+
+        return text.substr(begin, index.offset(line + 1u) - 1u - begin);
+    }
+}
+
+TEST_CASE("empty", "LineIndexTests") {
+    CHECK( build("").count == 0u );
+}
+
+TEST_CASE("one line", "LineIndexTests") {
+    CHECK( build("a").count == 1u );
+    CHECK( build("a\n").count == 1u );
+    CHECK( build("\n").count == 1u );
+    CHECK( getLine("abc", build("abc"), 0u) == "abc" );
+    CHECK( getLine("abc\n", build("abc\n"), 0u) == "abc" );
+}
+
+TEST_CASE("several lines", "LineIndexTests") {
+    std::string_view const text = "a\n\nbc\nd";
+    auto const index = build(text);
+
+    REQUIRE( index.count == 4u );
+    CHECK( getLine(text, index, 0u) == "a" );
+    CHECK( getLine(text, index, 1u) == "" );
+    CHECK( getLine(text, index, 2u) == "bc" );
+    CHECK( getLine(text, index, 3u) == "d" );
+}
+
+TEST_CASE("checkpoints", "LineIndexTests") {
+    std::string text;
+
+    for (auto i = 0u; i < LineIndex::CheckpointInterval * 3u; ++i)
+        text += std::string(10u, 'a' + i % 26u) + "\n";
+
+    auto const index = build(text);
+
+    REQUIRE( index.count == LineIndex::CheckpointInterval * 3u );
+    CHECK( index.checkpoints.size() == 4u );
+    CHECK( index.deltaWidth == 2u );
+
+    for (auto i = 0u; i < index.count; ++i)
+        CHECK( getLine(text, index, i) == std::string(10u, 'a' + i % 26u) );
+}
@@ -32,4 +32,32 @@ TEST_CASE("format", "StringTests")
     REQUIRE( format("{}") == "" );
     REQUIRE( format("{}", 123) == "123" );
     REQUIRE( format("{} yo {}", 123, "456") == "123 yo 456" );
+    REQUIRE( format("{}", static_cast<char const*>("yo")) == "yo" );
+}
+
+TEST_CASE("split", "StringTests")
+{
+    REQUIRE( split("", ',') == std::vector<std::string_view>{""} );
+    REQUIRE( split("a,b", ',') == std::vector<std::string_view>{"a", "b"} );
+    REQUIRE( split("a,,b,", ',') == std::vector<std::string_view>{"a", "", "b", ""} );
+}
+
+TEST_CASE("toCppStringLiteral", "StringTests")
+{
+    REQUIRE( toCppStringLiteral("") == "\"\"" );
+    REQUIRE( toCppStringLiteral("a\"b\\c") == "\"a\\\"b\\\\c\"" );
+    REQUIRE( toCppStringLiteral("\n1") == "\"\\0121\"" );
+}
+
+TEST_CASE("matchGlob", "StringTests")
+{
+    REQUIRE( matchGlob("", "") );
+    REQUIRE( matchGlob("*.json", "a.json") );
+    REQUIRE( matchGlob("*.json", ".json") );
+    REQUIRE( !matchGlob("*.json", "a/b.json") );
+    REQUIRE( matchGlob("**.json", "a/b.json") );
+    REQUIRE( matchGlob("a/**/c.txt", "a/b/b/c.txt") );
+    REQUIRE( matchGlob("shader?.glsl", "shader1.glsl") );
+    REQUIRE( !matchGlob("shader?.glsl", "shader.glsl") );
+    REQUIRE( !matchGlob("a", "ab") );
 }
@@ -0,0 +1,173 @@
+#include <Tar.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <Configuration.hpp>
+#include <ConfigurationParser.hpp>
+#include <FileSystem.hpp>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+
+namespace
+{
+    void writeHeader(std::vector<char>& archive, std::string const& name, std::size_t size, char type)
+    {
+        char header[512] = {};
+
+        std::memcpy(header, name.data(), std::min<std::size_t>(name.size(), 100u));
+        std::snprintf(header + 100, 8, "%07o", 0644);
+        std::snprintf(header + 124, 12, "%011o", static_cast<unsigned int>(size));
+        std::memset(header + 148, ' ', 8);
+        header[156] = type;
+        std::memcpy(header + 257, "ustar", 6);
+        std::memcpy(header + 263, "00", 2);
+
+        unsigned int checksum = 0u;
+
+        for (auto const c : header)
+            checksum += static_cast<unsigned char>(c);
+        std::snprintf(header + 148, 8, "%06o", checksum);
+
+        archive.insert(archive.end(), header, header + 512);
+    }
+
+    void writeData(std::vector<char>& archive, std::string const& data)
+    {
+        archive.insert(archive.end(), data.begin(), data.end());
+        archive.resize((archive.size() + 511u) / 512u * 512u, '\0');
+    }
+
+    /// Build an archive, each file is a pair (path, content).
+    std::vector<char> makeArchive(std::vector<std::pair<std::string, std::string>> const& files)
+    {
+        std::vector<char> archive;
+
+        for (auto const& [path, content] : files)
+        {
+            if (path.back() == '/')
+            {
+                writeHeader(archive, path, 0u, '5');
+                continue;
+            }
+
+            if (path.size() > 100u)
+            {
+                writeHeader(archive, "././@LongLink", path.size() + 1u, 'L');
+                writeData(archive, path + '\0');
+            }
+
+            writeHeader(archive, path, content.size(), '0');
+            writeData(archive, content);
+        }
+
+        archive.resize(archive.size() + 1024u, '\0');
+
+        return archive;
+    }
+
+    std::vector<TarMember> list(std::vector<char> const& archive)
+    {
+        return listTarMembers([&archive](std::uint64_t offset, std::size_t size, std::vector<char>& buffer)
+        {
+            REQUIRE( offset + size <= archive.size() );
+            buffer.assign(archive.begin() + static_cast<std::ptrdiff_t>(offset), archive.begin() + static_cast<std::ptrdiff_t>(offset + size));
+        }, archive.size());
+    }
+
+    std::string getContent(std::vector<char> const& archive, TarMember const& member)
+    {
+        return std::string(archive.data() + member.offset, member.size);
+    }
+}
+
+TEST_CASE("empty archive", "[TarTests]") {
+    CHECK( list(makeArchive({})).empty() );
+    CHECK( list({}).empty() );
+}
+
+TEST_CASE("archive members", "[TarTests]") {
+    auto const archive = makeArchive({{"icons/", ""}, {"icons/close.svg", "<svg/>"}, {"./readme.txt", "hello"}, {"empty.txt", ""}});
+    auto const members = list(archive);
+
+    REQUIRE( members.size() == 3u );
+    CHECK( members[0].path == "icons/close.svg" );
+    CHECK( getContent(archive, members[0]) == "<svg/>" );
+    CHECK( members[1].path == "readme.txt" );
+    CHECK( getContent(archive, members[1]) == "hello" );
+    CHECK( members[2].path == "empty.txt" );
+    CHECK( members[2].size == 0u );
+}
+
+TEST_CASE("archive long names", "[TarTests]") {
+    std::string const longPath = std::string(120u, 'a') + "/file.txt";
+    auto const archive = makeArchive({{longPath, "long"}, {"short.txt", "short"}});
+    auto const members = list(archive);
+
+    REQUIRE( members.size() == 2u );
+    CHECK( members[0].path == longPath );
+    CHECK( getContent(archive, members[0]) == "long" );
+    CHECK( members[1].path == "short.txt" );
+}
+
+TEST_CASE("invalid archives", "[TarTests]") {
+    auto archive = makeArchive({{"a.txt", "hello"}});
+
+    archive[0] = 'b';
+    CHECK_THROWS( list(archive) );
+
+    auto const truncated = makeArchive({{"a.txt", std::string(2000u, 'x')}});
+
+    CHECK_THROWS( list(std::vector<char>(truncated.begin(), truncated.begin() + 1024)) );
+    CHECK_THROWS( list(makeArchive({{"../a.txt", "hello"}})) );
+    CHECK_THROWS( list(makeArchive({{"./icons/../../a.txt", "hello"}})) );
+    CHECK_THROWS( list(makeArchive({{"/etc/a.txt", "hello"}})) );
+    CHECK( list(makeArchive({{"a\"b\\c..txt", "hello"}}))[0].path == "a\"b\\c..txt" );
+}
+
+TEST_CASE("tar option", "[TarTests]") {
+    auto filesystem = std::make_unique<InMemoryFileSystem>();
+    auto archive = makeArchive({{"icons/close.svg", "<svg/>"}, {"icons/open.svg", "<svg></svg>"}, {"config.json", "{}"}});
+    auto const archiveSize = archive.size();
+
+    filesystem->add("bundle.tar", std::move(archive));
+
+    ConfigurationParser parser{std::move(filesystem)};
+    auto const all = parser.parseText("@options *.json | json\nbundle.tar | tar lines", "memory");
+    auto const icons = parser.parseText("bundle.tar | tar=icons/*", "memory");
+
+    REQUIRE( all.inputs.size() == 3u );
+    CHECK( all.inputs[0].key == "config.json" );
+    CHECK( all.inputs[0].json );
+    CHECK( all.inputs[0].lineIndex );
+    CHECK( all.inputs[0].size == 2u );
+    CHECK( all.inputs[0].archiveOffset.has_value() );
+    CHECK( *all.inputs[0].archiveOffset < archiveSize );
+    CHECK( all.inputs[0].filePath == "bundle.tar" );
+    CHECK( all.inputs[1].key == "icons/close.svg" );
+    CHECK_FALSE( all.inputs[1].json );
+    CHECK( all.inputs[1].lineIndex );
+    CHECK( !all.inputs[1].archiveGlob.has_value() );
+
+    REQUIRE( icons.inputs.size() == 2u );
+    CHECK( icons.inputs[0].key == "icons/close.svg" );
+    CHECK( icons.inputs[1].key == "icons/open.svg" );
+}
+
+TEST_CASE("duplicated tar member", "[TarTests]") {
+    auto filesystem = std::make_unique<InMemoryFileSystem>();
+    auto const archive = makeArchive({{"a.txt", "first"}, {"b.txt", "b"}, {"a.txt", "second"}, {"c.txt", "c"}});
+
+    filesystem->add("bundle.tar", std::vector<char>(archive));
+
+    ConfigurationParser parser{std::move(filesystem)};
+    auto const configuration = parser.parseText("bundle.tar | tar", "memory");
+
+    // The last member stored with a path is used, like tar extracts it
+    REQUIRE( configuration.inputs.size() == 3u );
+    CHECK( configuration.inputs[0].key == "a.txt" );
+    CHECK( std::string(archive.data() + *configuration.inputs[0].archiveOffset, configuration.inputs[0].size) == "second" );
+    CHECK( configuration.inputs[1].key == "b.txt" );
+    CHECK( configuration.inputs[2].key == "c.txt" );
+}
@@ -0,0 +1,105 @@
+#include <Transform.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <FileSystem.hpp>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace
+{
+    std::string transform(std::string_view text, std::string const& name, std::string_view argument = {},
+                          std::optional<std::filesystem::path> const& cacheDirectory = {})
+    {
+        std::vector<char> buffer(text.begin(), text.end());
+
+        applyTransforms({instanciateTransform(name, argument)}, buffer, cacheDirectory);
+
+        return std::string(buffer.begin(), buffer.end());
+    }
+
+    class UpperCaseTransform : public Transform
+    {
+    public:
+        void apply(std::vector<char>& buffer) const override
+        {
+            for (auto& c : buffer)
+                c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+        }
+
+        std::string identity() const override
+        {
+            return "upper";
+        }
+    };
+}
+
+TEST_CASE("strip-bom", "TransformTests") {
+    CHECK( transform("\xEF\xBB\xBFhello", "strip-bom") == "hello" );
+    CHECK( transform("hello", "strip-bom") == "hello" );
+    CHECK_THROWS( instanciateTransform("strip-bom", "yes") );
+}
+
+TEST_CASE("eol", "TransformTests") {
+    CHECK( transform("a\r\nb\rc\n", "eol", "lf") == "a\nb\nc\n" );
+    CHECK( transform("a\r\nb\n", "eol", "crlf") == "a\r\nb\r\n" );
+    CHECK_THROWS( instanciateTransform("eol", "cr") );
+}
+
+TEST_CASE("minify-whitespace", "TransformTests") {
+    CHECK( transform("  a  b \n\n\t c\r\n", "minify-whitespace") == "a  b\nc\n" );
+}
+
+TEST_CASE("minify-json", "TransformTests") {
+    CHECK( transform("{ \"a b\" : [ 1, \"\\\" x\" ] }\n", "minify-json") == "{\"a b\":[1,\"\\\" x\"]}" );
+    CHECK_THROWS( transform("{ \"a\": }", "minify-json") );
+}
+
+TEST_CASE("minify-xml", "TransformTests") {
+    CHECK( transform("<a>\n  <!-- comment -->\n  <b x=\"1\"> text </b>\n  <![CDATA[ <c> ]]>\n</a>\n", "minify-xml") == "<a><b x=\"1\"> text </b><![CDATA[ <c> ]]></a>" );
+    CHECK_THROWS( transform("<a><!-- </a>", "minify-xml") );
+}
+
+TEST_CASE("exec", "TransformTests") {
+    CHECK( transform("hello", "exec", "cmake -E copy {input} {output}") == "hello" );
+    CHECK_THROWS( transform("hello", "exec", "cmake -E false {input} {output}") );
+    CHECK_THROWS( instanciateTransform("exec", "cmake -E copy") );
+
+    // Each run uses its own temporary files, removed afterwards
+    auto const firstInput = transform("hello", "exec", "cmake -E echo {input} > {output}");
+    auto const secondInput = transform("hello", "exec", "cmake -E echo {input} > {output}");
+
+    CHECK( firstInput != secondInput );
+    CHECK( !std::filesystem::exists(firstInput.substr(0u, firstInput.find_last_not_of("\r\n") + 1u)) );
+    CHECK( !std::filesystem::exists(secondInput.substr(0u, secondInput.find_last_not_of("\r\n") + 1u)) );
+}
+
+TEST_CASE("custom transform", "TransformTests") {
+    registerTransform("upper", [](std::string_view) { return std::make_shared<UpperCaseTransform>(); });
+
+    CHECK( isTransformRegistered("upper") );
+    CHECK( transform("hello", "upper") == "HELLO" );
+    CHECK_THROWS( instanciateTransform("yolo", {}) );
+}
+
+TEST_CASE("cache", "TransformTests") {
+    auto const cacheDirectory = std::filesystem::temp_directory_path() / "rescom_transform_tests_cache";
+
+    std::filesystem::remove_all(cacheDirectory);
+
+    CHECK( transform("hello", "exec", "cmake -E copy {input} {output}", cacheDirectory) == "hello" );
+    REQUIRE( std::distance(std::filesystem::directory_iterator(cacheDirectory), std::filesystem::directory_iterator{}) == 1 );
+
+    // The command fails, so the result can only come from the cache.
+    auto const cachedFile = std::filesystem::directory_iterator(cacheDirectory)->path();
+
+    std::filesystem::resize_file(cachedFile, 2u);
+    CHECK( transform("hello", "exec", "cmake -E copy {input} {output}", cacheDirectory) == "he" );
+
+    // Each run of rescom writes the files of the cache under its own temporary name
+    CHECK( makeTemporaryPath(cachedFile) != makeTemporaryPath(cachedFile) );
+    CHECK( makeTemporaryPath(cachedFile).parent_path() == cacheDirectory );
+
+    std::filesystem::remove_all(cacheDirectory);
+}
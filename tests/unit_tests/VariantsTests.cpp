@@ -0,0 +1,51 @@
+#include <Variants.hpp>
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+
+namespace
+{
+    VariantDimension const Locale{"locale", {"en", "fr", "en-GB", "fr-CA", "de"}, {std::nullopt, std::nullopt, 0u, 1u, 0u}, 1u};
+
+    std::vector<std::optional<std::size_t>> resolve(VariantGroup const& group, std::vector<std::string> const& keys)
+    {
+        return resolveVariants(group, Locale, [&keys](std::string const& key) -> std::optional<std::size_t>
+        {
+            auto const it = std::find(keys.begin(), keys.end(), key);
+
+            if (it == keys.end())
+                return std::nullopt;
+
+            return static_cast<std::size_t>(it - keys.begin());
+        });
+    }
+}
+
+TEST_CASE("variant key", "[VariantsTests]") {
+    CHECK( makeVariantKey(VariantGroup{"strings.json", "strings/{locale}.json", 0u, 1u}, Locale, 2u) == "strings/en-GB.json" );
+    CHECK( makeVariantKey(VariantGroup{"menu", "{locale}/menu.{locale}", 0u, 1u}, Locale, 1u) == "fr/menu.fr" );
+}
+
+TEST_CASE("resolve variants", "[VariantsTests]") {
+    VariantGroup const group{"strings.json", "strings/{locale}.json", 0u, 1u};
+    auto const resolved = resolve(group, {"strings/en.json", "strings/fr-CA.json", "strings/en-GB.json"});
+
+    REQUIRE( resolved.size() == 5u );
+    CHECK( resolved[0] == 0u );
+    CHECK( !resolved[1].has_value() );
+    CHECK( resolved[2] == 2u );
+    CHECK( resolved[3] == 1u );
+    CHECK( resolved[4] == 0u );
+}
+
+TEST_CASE("resolve variants with default", "[VariantsTests]") {
+    VariantGroup const group{"strings.json", "strings/{locale}.json", 0u, 1u};
+    auto const resolved = resolve(group, {"strings.json", "strings/fr.json"});
+
+    REQUIRE( resolved.size() == 5u );
+    CHECK( resolved[0] == 0u );
+    CHECK( resolved[1] == 1u );
+    CHECK( resolved[2] == 0u );
+    CHECK( resolved[3] == 1u );
+    CHECK( resolved[4] == 0u );
+}